@@ -0,0 +1,196 @@
+#ifndef AGENT_H
+#define AGENT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GameEngine.h"
+#include "GameRng.h"
+
+/**
+ * @brief Makes the decisions of one player
+ * @details The game loop asks the agent of the current player for each choice of a turn,
+ *          in turn order, and carries it out through the GameEngine. Every callback receives
+ *          the engine read-only, so an agent sees the same table a player would.
+ */
+class Agent
+{
+public:
+    /**
+     * @brief Decides whether to pause the game and save it
+     * @param engine The game in progress
+     * @param filename Set to the file to save to when returning true
+     * @return true to save the game before the turn starts
+     */
+    virtual bool pauseToSave(const GameEngine &engine, std::string &filename)
+    {
+        (void)engine;
+        (void)filename;
+        return false;
+    }
+
+    /**
+     * @brief Decides whether to keep playing after saving
+     * @param engine The game in progress
+     * @return false to end the session
+     */
+    virtual bool continueAfterSave(const GameEngine &engine)
+    {
+        (void)engine;
+        return true;
+    }
+
+    /**
+     * @brief Decides whether to buy a third field; only asked when GameEngine::canBuyThirdChain() holds
+     * @param engine The game in progress
+     * @return true to buy it
+     */
+    virtual bool buyThirdChain(const GameEngine &engine) = 0;
+
+    /**
+     * @brief Picks the next card to take from the trade area; asked until it returns false
+     *        or the trade area is empty
+     * @param engine The game in progress
+     * @param bean Set to the bean type to chain when returning true
+     * @return false to stop taking cards
+     */
+    virtual bool chooseTradeBean(const GameEngine &engine, BeanId &bean) = 0;
+
+    /**
+     * @brief Decides whether to plant the new front card of the hand as well
+     * @param engine The game in progress
+     * @return true to plant a second card
+     */
+    virtual bool playSecondCard(const GameEngine &engine) = 0;
+
+    /**
+     * @brief Picks a chain to harvest
+     * @param engine The game in progress
+     * @return Index of the chain to harvest, -1 to harvest nothing
+     */
+    virtual int chooseChainToHarvest(const GameEngine &engine) = 0;
+
+    /**
+     * @brief Picks a card of the hand to discard
+     * @param engine The game in progress
+     * @return Index of the card in the hand, -1 to discard nothing
+     */
+    virtual int chooseCardToDiscard(const GameEngine &engine) = 0;
+
+    /** @brief Virtual destructor for proper cleanup of derived classes */
+    virtual ~Agent() = default;
+};
+
+/**
+ * @brief Asks a person at the terminal for every decision
+ */
+class TerminalAgent : public Agent
+{
+public:
+    /**
+     * @brief Constructs an agent that prompts on out and reads answers from in
+     * @param in Stream to read answers from
+     * @param out Stream to write prompts to
+     */
+    TerminalAgent(std::istream &in, std::ostream &out) : in(in), out(out) {}
+
+    /**
+     * @brief Asks a yes/no question until the answer is 'y' or 'n'
+     * @param prompt The question to ask
+     * @return true if the answer is 'y'
+     */
+    bool ask(const std::string &prompt);
+
+    bool pauseToSave(const GameEngine &engine, std::string &filename) override;
+    bool continueAfterSave(const GameEngine &engine) override;
+    bool buyThirdChain(const GameEngine &engine) override;
+    bool chooseTradeBean(const GameEngine &engine, BeanId &bean) override;
+    bool playSecondCard(const GameEngine &engine) override;
+    int chooseChainToHarvest(const GameEngine &engine) override;
+    int chooseCardToDiscard(const GameEngine &engine) override;
+
+private:
+    std::istream &in;  ///< Stream answers are read from
+    std::ostream &out; ///< Stream prompts are written to
+
+    /**
+     * @brief Reads a whole-line integer answer
+     * @return The number read
+     */
+    int readIndex();
+};
+
+/**
+ * @brief Makes uniformly random choices among the moves that are allowed
+ */
+class RandomAgent : public Agent
+{
+public:
+    /**
+     * @brief Constructs an agent drawing its choices from a generator
+     * @param rng Generator for the choices; give each agent its own stream
+     */
+    explicit RandomAgent(const GameRng &rng) : rng(rng) {}
+
+    bool buyThirdChain(const GameEngine &engine) override;
+    bool chooseTradeBean(const GameEngine &engine, BeanId &bean) override;
+    bool playSecondCard(const GameEngine &engine) override;
+    int chooseChainToHarvest(const GameEngine &engine) override;
+    int chooseCardToDiscard(const GameEngine &engine) override;
+
+private:
+    GameRng rng; ///< Source of the choices
+};
+
+/**
+ * @brief Grows its existing chains and harvests only when a chain is full or a field is needed
+ */
+class GreedyAgent : public Agent
+{
+public:
+    bool buyThirdChain(const GameEngine &engine) override;
+    bool chooseTradeBean(const GameEngine &engine, BeanId &bean) override;
+    bool playSecondCard(const GameEngine &engine) override;
+    int chooseChainToHarvest(const GameEngine &engine) override;
+    int chooseCardToDiscard(const GameEngine &engine) override;
+};
+
+/**
+ * @brief Replays a fixed list of decisions, for regression runs and reproducing games
+ * @details Each decision consumes the next number of the script:
+ *          - yes/no decisions: 0 is no, anything else is yes
+ *          - trade area: the BeanId of the bean to take, -1 to stop
+ *          - harvest and discard: the chain or hand index, -1 for none
+ *          Once the script runs out, every decision is declined.
+ */
+class ScriptedAgent : public Agent
+{
+public:
+    /**
+     * @brief Constructs an agent that replays a script
+     * @param script The decisions, in the order they will be asked
+     */
+    explicit ScriptedAgent(std::vector<int> script) : script(std::move(script)) {}
+
+    bool buyThirdChain(const GameEngine &engine) override;
+    bool chooseTradeBean(const GameEngine &engine, BeanId &bean) override;
+    bool playSecondCard(const GameEngine &engine) override;
+    int chooseChainToHarvest(const GameEngine &engine) override;
+    int chooseCardToDiscard(const GameEngine &engine) override;
+
+    /** @brief Number of script entries not yet used */
+    std::size_t remaining() const { return script.size() - next; }
+
+private:
+    std::vector<int> script; ///< Decisions in the order they are asked
+    std::size_t next = 0;    ///< Index of the next decision
+
+    /**
+     * @brief Takes the next decision from the script
+     * @param fallback Value returned once the script is exhausted
+     */
+    int take(int fallback) { return next < script.size() ? script[next++] : fallback; }
+};
+
+#endif // AGENT_H
@@ -0,0 +1,107 @@
+#ifndef BEAN_REGISTRY_H
+#define BEAN_REGISTRY_H
+
+#include <array>
+#include <utility>
+#include <type_traits>
+#include "Card.h"
+
+/**
+ * @brief A compile-time list of bean card types.
+ */
+template <typename... Beans>
+struct BeanList {
+    static constexpr int size = sizeof...(Beans);
+};
+
+/**
+ * @brief Every bean type in the game, in BeanId order.
+ *        This is the single list the registry dispatches over: adding a bean type means
+ *        adding its class to this line (after giving it a BeanId, a beanometer row and a name).
+ */
+using AllBeans = BeanList<Blue, Chili, Stink, Green, Soy, Black, Red, Garden>;
+
+namespace bean_registry_detail {
+
+template <int I, typename List>
+struct TypeAt;
+
+template <int I, typename Head, typename... Tail>
+struct TypeAt<I, BeanList<Head, Tail...>> : TypeAt<I - 1, BeanList<Tail...>> {};
+
+template <typename Head, typename... Tail>
+struct TypeAt<0, BeanList<Head, Tail...>> {
+    using type = Head;
+};
+
+// True when every type's ID matches its position in the list
+template <int I, typename List>
+struct IdsInOrder : std::true_type {};
+
+template <int I, typename Head, typename... Tail>
+struct IdsInOrder<I, BeanList<Head, Tail...>>
+    : std::integral_constant<bool, static_cast<int>(Head::ID) == I &&
+                                       IdsInOrder<I + 1, BeanList<Tail...>>::value> {};
+
+template <typename List>
+struct Registry;
+
+template <typename... Beans>
+struct Registry<BeanList<Beans...>> {
+    static constexpr std::array<const Card *, sizeof...(Beans)> flyweights() {
+        return {{&BeanCreator<Beans>::instance()...}};
+    }
+
+    template <typename F>
+    using Result = decltype(std::declval<F &>()(BeanCreator<typename TypeAt<0, BeanList<Beans...>>::type>::instance()));
+
+    template <typename T, typename F>
+    static Result<F> call(F &f) { return f(BeanCreator<T>::instance()); }
+
+    template <typename F>
+    static Result<F> dispatch(BeanId id, F &f) {
+        static constexpr Result<F> (*const table[])(F &) = {&call<Beans, F>...};
+        return table[static_cast<int>(id)](f);
+    }
+};
+
+} // namespace bean_registry_detail
+
+static_assert(AllBeans::size == NUM_BEAN_TYPES, "AllBeans must list every BeanId exactly once");
+static_assert(bean_registry_detail::IdsInOrder<0, AllBeans>::value, "AllBeans must be in BeanId order");
+
+/**
+ * @brief Maps a BeanId to its bean class at compile time, e.g. BeanType<BeanId::Red> is Red.
+ */
+template <BeanId id>
+using BeanType = typename bean_registry_detail::TypeAt<static_cast<int>(id), AllBeans>::type;
+
+/**
+ * @brief The BeanRegistry generates per-bean-type code from AllBeans.
+ *        dispatch() turns a runtime BeanId into a call on the matching bean class through
+ *        a constexpr jump table, replacing dynamic_cast and name comparison ladders.
+ */
+class BeanRegistry {
+public:
+    /**
+     * @brief Call f with the shared instance of the bean type identified by id.
+     *        f is typically a generic lambda; the static type of its argument is the bean class,
+     *        e.g. [&](const auto &bean) { player.addCardToChain<std::decay_t<decltype(bean)>>(card); }
+     * @param id The bean type to dispatch on.
+     * @param f The callable to invoke.
+     * @return Whatever f returns (f must return the same type for every bean).
+     */
+    template <typename F>
+    static decltype(auto) dispatch(BeanId id, F &&f) {
+        return bean_registry_detail::Registry<AllBeans>::dispatch(id, f);
+    }
+
+    /**
+     * @brief Table of the shared bean instances, indexed by BeanId.
+     */
+    static constexpr std::array<const Card *, NUM_BEAN_TYPES> flyweights() {
+        return bean_registry_detail::Registry<AllBeans>::flyweights();
+    }
+};
+
+#endif // BEAN_REGISTRY_H
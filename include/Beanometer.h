@@ -0,0 +1,114 @@
+#ifndef BEANOMETER_H
+#define BEANOMETER_H
+
+#include <cstdint>
+#include "Card.h"
+
+namespace beanometer_detail {
+
+/**
+ * @brief Cards needed for 1, 2, 3 and 4 coins, per bean type in BeanId order.
+ *        A zero means that coin value cannot be earned with this bean.
+ */
+constexpr std::uint8_t THRESHOLDS[NUM_BEAN_TYPES][4] = {
+    {4, 6, 8, 10}, // Blue
+    {3, 6, 8, 9},  // Chili
+    {3, 5, 7, 8},  // Stink
+    {3, 5, 6, 7},  // Green
+    {2, 4, 6, 7},  // Soy
+    {2, 4, 5, 6},  // Black
+    {2, 3, 4, 5},  // Red
+    {0, 2, 3, 0},  // Garden
+};
+
+/** @brief Longest chain the table covers; no bean has more cards than this. */
+constexpr int MAX_CHAIN_LENGTH = 20;
+
+/** @brief One beanometer reading: coins earned and cards still needed for the next coin. */
+struct Entry {
+    std::uint8_t coins;
+    std::uint8_t cardsToNextCoin; ///< 0 once the chain is worth the most it can be
+};
+
+struct Table {
+    Entry entries[NUM_BEAN_TYPES][MAX_CHAIN_LENGTH + 1];
+};
+
+/**
+ * @brief Evaluate every (bean, chain length) pair of the beanometer at compile time.
+ */
+constexpr Table build()
+{
+    Table table{};
+    for (int bean = 0; bean < NUM_BEAN_TYPES; ++bean)
+    {
+        for (int length = 0; length <= MAX_CHAIN_LENGTH; ++length)
+        {
+            int coins = 0;
+            int toNext = 0;
+            for (int c = 1; c <= 4; ++c)
+            {
+                int needed = THRESHOLDS[bean][c - 1];
+                if (needed == 0)
+                    continue;
+                if (length >= needed)
+                    coins = c;
+                else if (toNext == 0)
+                    toNext = needed - length;
+            }
+            table.entries[bean][length] = Entry{static_cast<std::uint8_t>(coins),
+                                                static_cast<std::uint8_t>(toNext)};
+        }
+    }
+    return table;
+}
+
+} // namespace beanometer_detail
+
+/**
+ * @brief The Beanometer is the compile-time payout table printed on every bean card.
+ *        Indexed by bean type and chain length, a single load yields both the coins a
+ *        chain is worth and how many more cards it needs to be worth one more coin.
+ */
+class Beanometer {
+public:
+    using Entry = beanometer_detail::Entry;
+
+    static constexpr int MAX_CHAIN_LENGTH = beanometer_detail::MAX_CHAIN_LENGTH;
+
+    /**
+     * @brief Read the beanometer for a chain.
+     * @param bean The chain's bean type.
+     * @param chainLength Number of cards in the chain (clamped to the table bounds).
+     * @return The coins the chain is worth and the cards needed for the next coin.
+     */
+    static constexpr Entry lookup(BeanId bean, int chainLength) {
+        return table.entries[static_cast<int>(bean)]
+                            [chainLength < 0 ? 0 : (chainLength > MAX_CHAIN_LENGTH ? MAX_CHAIN_LENGTH : chainLength)];
+    }
+
+    /** @brief Typed overload for templates that know their bean class (e.g. Chain<T>). */
+    template <typename T>
+    static constexpr Entry lookup(int chainLength) { return lookup(T::ID, chainLength); }
+
+    /** @brief Coins earned by selling a chain of chainLength beans. */
+    static constexpr int coins(BeanId bean, int chainLength) { return lookup(bean, chainLength).coins; }
+
+    /** @brief Cards still needed for the chain to earn one more coin, 0 if already at its maximum. */
+    static constexpr int cardsToNextCoin(BeanId bean, int chainLength) {
+        return lookup(bean, chainLength).cardsToNextCoin;
+    }
+
+    /**
+     * @brief Cards required to earn the given number of coins.
+     * @return The required chain length, or 0 if that many coins cannot be earned.
+     */
+    static constexpr int cardsPerCoin(BeanId bean, int coins) {
+        return (coins < 1 || coins > 4) ? 0 : beanometer_detail::THRESHOLDS[static_cast<int>(bean)][coins - 1];
+    }
+
+private:
+    static constexpr beanometer_detail::Table table = beanometer_detail::build();
+};
+
+#endif // BEANOMETER_H
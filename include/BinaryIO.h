@@ -0,0 +1,164 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Card.h"
+
+/**
+ * @brief Appends the fields of a binary save to a byte buffer
+ * @details Numbers are single bytes. Bean ids are packed two to a byte, the first in the
+ *          high nibble, and an odd count is padded with a zero nibble.
+ */
+class ByteWriter
+{
+public:
+    /**
+     * @brief Constructs a writer that appends to a buffer
+     * @param buffer The buffer; it must outlive the writer
+     */
+    explicit ByteWriter(std::vector<std::uint8_t> &buffer) : buffer(buffer) {}
+
+    /**
+     * @brief Writes a number as one byte
+     * @param value The number
+     * @throws std::length_error if value is not between 0 and 255
+     */
+    void byte(int value)
+    {
+        checkByte(value);
+        buffer.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    /**
+     * @brief Writes raw bytes, e.g. a name
+     * @param data The bytes
+     * @param count Number of bytes
+     */
+    void bytes(const char *data, std::size_t count) { buffer.insert(buffer.end(), data, data + count); }
+
+    /**
+     * @brief Writes bean ids two to a byte
+     * @param beans The bean ids
+     * @param count Number of bean ids
+     */
+    void beans(const BeanId *beans, std::size_t count);
+
+    /**
+     * @brief Writes a pile of bean ids as a change to an earlier copy: the number of bottom
+     *        ids the two share, the number above them, then those ids two to a byte
+     * @param beans The pile, bottom first
+     * @param count Number of bean ids in the pile
+     * @param base The earlier copy, bottom first
+     * @param baseCount Number of bean ids in the earlier copy
+     * @throws std::length_error if a count does not fit in a byte
+     */
+    void beanDelta(const BeanId *beans, std::size_t count, const BeanId *base, std::size_t baseCount);
+
+    /** @brief Number of bytes in the buffer, i.e. the offset of the next byte written */
+    std::size_t size() const { return buffer.size(); }
+
+    /**
+     * @brief Overwrites a byte written earlier, e.g. a length known only after its section
+     * @param offset Offset of the byte in the buffer
+     * @param value The number
+     * @throws std::length_error if value is not between 0 and 255
+     */
+    void patch(std::size_t offset, int value)
+    {
+        checkByte(value);
+        buffer[offset] = static_cast<std::uint8_t>(value);
+    }
+
+private:
+    std::vector<std::uint8_t> &buffer; ///< Where bytes are appended
+
+    /** @brief Throws if a number does not fit in a byte */
+    static void checkByte(int value)
+    {
+        if (value < 0 || value > 255)
+        {
+            throw std::length_error("Value does not fit in a binary save: " + std::to_string(value));
+        }
+    }
+};
+
+/**
+ * @brief Reads the fields of a binary save from a range of bytes, as ByteWriter wrote them
+ * @details Every read is bounds checked: running past the end, or a bean id that is not a
+ *          bean, throws std::runtime_error. Nothing is copied or allocated.
+ */
+class ByteReader
+{
+public:
+    /**
+     * @brief Constructs a reader over a range of bytes
+     * @param data First byte; the bytes must outlive the reader
+     * @param size Number of bytes
+     */
+    ByteReader(const std::uint8_t *data, std::size_t size) : next(data), end(data + size) {}
+
+    /**
+     * @brief Reads a one-byte number
+     * @throws std::runtime_error if no byte is left
+     */
+    int byte()
+    {
+        need(1);
+        return *next++;
+    }
+
+    /**
+     * @brief Skips over raw bytes
+     * @param count Number of bytes
+     * @return The first of them
+     * @throws std::runtime_error if fewer bytes are left
+     */
+    const std::uint8_t *bytes(std::size_t count)
+    {
+        need(count);
+        const std::uint8_t *start = next;
+        next += count;
+        return start;
+    }
+
+    /**
+     * @brief Reads bean ids packed two to a byte
+     * @param beans Filled with the bean ids
+     * @param count Number of bean ids
+     * @throws std::runtime_error if the bytes run out, a nibble is not a bean or the padding is not zero
+     */
+    void beans(BeanId *beans, std::size_t count);
+
+    /**
+     * @brief Reads a pile of bean ids as ByteWriter::beanDelta() wrote it against a base
+     * @param beans Filled with the pile, bottom first
+     * @param capacity Most bean ids beans can hold
+     * @param base The copy the change was written against, bottom first
+     * @param baseCount Number of bean ids in it
+     * @return Number of bean ids in the pile
+     * @throws std::runtime_error if the data is malformed or does not fit the base or the capacity
+     */
+    std::size_t beanDelta(BeanId *beans, std::size_t capacity, const BeanId *base, std::size_t baseCount);
+
+    /** @brief Number of bytes left */
+    std::size_t remaining() const { return static_cast<std::size_t>(end - next); }
+
+private:
+    const std::uint8_t *next; ///< Next byte to read
+    const std::uint8_t *end;  ///< One past the last byte
+
+    /** @brief Throws if fewer bytes are left than needed */
+    void need(std::size_t count) const
+    {
+        if (remaining() < count)
+        {
+            throw std::runtime_error("Binary save is truncated");
+        }
+    }
+};
+
+#endif // BINARY_IO_H
@@ -5,25 +5,64 @@
 #include <ostream>
 #include <iostream>
 #include <memory>
+#include <array>
+#include <cstdint>
 
 // Forward declarations
 class CardFactory;
 template <typename T>
 class BeanCreator;
 
+/**
+ * @brief Compact one-byte identifier for a bean type.
+ *        Containers store BeanIds and resolve them to the shared Card instance on demand.
+ */
+enum class BeanId : std::uint8_t {
+    Blue,
+    Chili,
+    Stink,
+    Green,
+    Soy,
+    Black,
+    Red,
+    Garden
+};
+
+/** @brief Number of distinct bean types (and valid BeanId values). */
+constexpr int NUM_BEAN_TYPES = 8;
+
+/** @brief Number of cards in a full game (the size of a new deck). */
+constexpr int NUM_CARDS = 104;
+
 /**
  * @brief The Card class is an abstract base class representing a generic bean card.
- *        It defines the interface for getting the bean's name, printing it, cloning,
+ *        It defines the interface for getting the bean's name, printing it,
  *        and determining how many cards are needed for a given number of coins.
+ *        Every bean type exists exactly once as an immutable flyweight; cards are
+ *        handed around as const Card pointers to that shared instance.
  */
 class Card {
 public:
+    /**
+     * @brief Get the shared instance for a bean type.
+     * @param id The bean type.
+     * @return Pointer to the immutable flyweight for that bean type.
+     */
+    static const Card *get(BeanId id) { return instances[static_cast<int>(id)]; }
+
+    /**
+     * @brief Get the bean type of this card.
+     * @return The card's BeanId.
+     */
+    BeanId getId() const { return id; }
+
     /**
      * @brief Given a number of coins, returns how many cards of this type are required to earn that many coins.
      * @param coins The number of coins desired.
      * @return The number of cards needed for that coin value, or 0 if not applicable.
+     * @note Reads the compile-time Beanometer table; hot paths should use Beanometer directly.
      */
-    virtual int getCardsPerCoin(int coins) const = 0;
+    int getCardsPerCoin(int coins) const;
 
     /**
      * @brief Get the name of the card type (e.g. "Blue", "Chili").
@@ -37,12 +76,6 @@ public:
      */
     virtual void print(std::ostream &out) const = 0;
 
-    /**
-     * @brief Create a clone of this card, returning a unique_ptr to the new card.
-     * @return A unique_ptr to a newly allocated card of the same type.
-     */
-    virtual std::unique_ptr<Card> clone() const = 0;
-
     // Delete copy operations to avoid accidental copying
     Card(const Card &) = delete;
     Card &operator=(const Card &) = delete;
@@ -55,27 +88,30 @@ public:
     virtual ~Card() {}
 
 protected:
-    Card() = default;
+    constexpr explicit Card(BeanId beanId) : id(beanId) {}
+
+private:
+    const BeanId id;
+
+    // Shared instances indexed by BeanId, generated from the BeanRegistry in Card.cpp
+    static const std::array<const Card *, NUM_BEAN_TYPES> instances;
 };
 
 /**
  * @brief The Blue bean card class.
- *        Has specific rules for getCardsPerCoin and a print representation.
+ *        Has its own payout row in the Beanometer and a print representation.
  */
 class Blue : public Card {
     friend class BeanCreator<Blue>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Blue;
+
     std::string getName() const override { return "Blue"; }
     void print(std::ostream &out) const override { out << 'B'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Blue>(new Blue());
-        return ptr;
-    }
 
 private:
-    Blue() = default;
+    constexpr Blue() : Card(ID) {}
 };
 
 /**
@@ -85,16 +121,13 @@ class Chili : public Card {
     friend class BeanCreator<Chili>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Chili;
+
     std::string getName() const override { return "Chili"; }
     void print(std::ostream &out) const override { out << 'C'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Chili>(new Chili());
-        return ptr;
-    }
 
 private:
-    Chili() = default;
+    constexpr Chili() : Card(ID) {}
 };
 
 /**
@@ -104,16 +137,13 @@ class Soy : public Card {
     friend class BeanCreator<Soy>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Soy;
+
     std::string getName() const override { return "Soy"; }
     void print(std::ostream &out) const override { out << 's'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Soy>(new Soy());
-        return ptr;
-    }
 
 private:
-    Soy() = default;
+    constexpr Soy() : Card(ID) {}
 };
 
 /**
@@ -123,16 +153,13 @@ class Stink : public Card {
     friend class BeanCreator<Stink>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Stink;
+
     std::string getName() const override { return "Stink"; }
     void print(std::ostream &out) const override { out << 'S'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Stink>(new Stink());
-        return ptr;
-    }
 
 private:
-    Stink() = default;
+    constexpr Stink() : Card(ID) {}
 };
 
 /**
@@ -142,16 +169,13 @@ class Black : public Card {
     friend class BeanCreator<Black>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Black;
+
     std::string getName() const override { return "Black"; }
     void print(std::ostream &out) const override { out << 'b'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Black>(new Black());
-        return ptr;
-    }
 
 private:
-    Black() = default;
+    constexpr Black() : Card(ID) {}
 };
 
 /**
@@ -161,16 +185,13 @@ class Green : public Card {
     friend class BeanCreator<Green>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Green;
+
     std::string getName() const override { return "Green"; }
     void print(std::ostream &out) const override { out << 'G'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Green>(new Green());
-        return ptr;
-    }
 
 private:
-    Green() = default;
+    constexpr Green() : Card(ID) {}
 };
 
 /**
@@ -180,16 +201,13 @@ class Red : public Card {
     friend class BeanCreator<Red>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Red;
+
     std::string getName() const override { return "Red"; }
     void print(std::ostream &out) const override { out << 'R'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Red>(new Red());
-        return ptr;
-    }
 
 private:
-    Red() = default;
+    constexpr Red() : Card(ID) {}
 };
 
 /**
@@ -199,21 +217,18 @@ class Garden : public Card {
     friend class BeanCreator<Garden>;
 
 public:
-    int getCardsPerCoin(int coins) const override;
+    static constexpr BeanId ID = BeanId::Garden;
+
     std::string getName() const override { return "Garden"; }
     void print(std::ostream &out) const override { out << 'g'; }
-    std::unique_ptr<Card> clone() const override {
-        auto ptr = std::unique_ptr<Garden>(new Garden());
-        return ptr;
-    }
 
 private:
-    Garden() = default;
+    constexpr Garden() : Card(ID) {}
 };
 
 /**
- * @brief The BeanCreator class is a template used by the CardFactory
- *        to create bean card instances. It provides a static create method.
+ * @brief The BeanCreator class template owns the single shared instance of each
+ *        bean card type T. It is the only class allowed to construct bean cards.
  */
 template <typename T>
 class BeanCreator {
@@ -221,16 +236,20 @@ class BeanCreator {
 
 public:
     /**
-     * @brief Create a new instance of the bean card type T.
-     * @return A unique_ptr to the newly created bean card.
+     * @brief Get the shared instance of the bean card type T.
+     * @return A reference to the immutable flyweight for T.
      */
-    static std::unique_ptr<T> create() {
-        auto ptr = std::unique_ptr<T>(new T());
-        return ptr;
-    }
+    static constexpr const T &instance() { return flyweight; }
 
 private:
     BeanCreator() = default;
+
+    static const T flyweight;
 };
 
+// The one shared instance of each bean type. Constructors are constexpr, so these are
+// constant-initialized and safe to use from any other static initializer.
+template <typename T>
+const T BeanCreator<T>::flyweight{};
+
 #endif // CARD_H
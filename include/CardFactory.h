@@ -3,14 +3,15 @@
 
 #include <vector>
 #include <memory>
-#include <map>
 #include "Card.h"
 #include "Deck.h"
+#include "GameRng.h"
 
 /**
- * @brief The CardFactory is a singleton class responsible for creating and managing all
- *        card instances. It initializes card pools, can shuffle them into a deck, and create
- *        individual cards by name for loading saved games.
+ * @brief The CardFactory is a singleton class responsible for the game's card composition.
+ *        It initializes the card pool, can shuffle it into a deck, and resolves
+ *        individual cards by name for loading saved games. Cards themselves are shared
+ *        flyweights (see BeanCreator), so no card is ever allocated.
  */
 class CardFactory {
 public:
@@ -20,33 +21,71 @@ public:
 
     /**
      * @brief Get the singleton instance of the CardFactory.
-     * @return A shared_ptr to the CardFactory instance.
+     *        The instance is immutable once constructed, so it can be shared by any
+     *        number of threads without locking or reference counting.
+     * @return A pointer to the CardFactory instance.
      */
-    static std::shared_ptr<CardFactory> getFactory();
+    static const CardFactory *getFactory();
 
     /**
      * @brief Create and return a deck populated with all the game's cards in a random order.
+     *        The order is drawn from a fresh non-deterministic seed.
      * @return A unique_ptr to a newly created and shuffled Deck.
      */
-    std::unique_ptr<Deck> getDeck();
+    std::unique_ptr<Deck> getDeck() const;
 
     /**
-     * @brief Create a single card by its name. Used when loading a saved game.
+     * @brief Create a deck shuffled from a game seed. The same seed always deals the same deck.
+     * @param seed 64-bit game seed.
+     * @return A unique_ptr to a newly created and shuffled Deck.
+     */
+    std::unique_ptr<Deck> getDeck(std::uint64_t seed) const;
+
+    /**
+     * @brief Create a deck shuffled by the given generator (e.g. a per-thread stream).
+     * @param rng The generator to draw from; it is advanced by the shuffle.
+     * @return A unique_ptr to a newly created and shuffled Deck.
+     */
+    std::unique_ptr<Deck> getDeck(GameRng &rng) const;
+
+    /**
+     * @brief Draw a fresh non-deterministic 64-bit game seed.
+     * @return A seed suitable for getDeck(std::uint64_t).
+     */
+    static std::uint64_t randomSeed();
+
+    /**
+     * @brief Get a single card by its name. Used when loading a saved game.
      * @param cardName The name of the card to create (e.g. "Blue", "Chili").
-     * @return A unique_ptr to the newly created Card.
+     * @return Pointer to the shared instance of that bean type.
      * @throws std::runtime_error if the card name is invalid.
      */
-    std::unique_ptr<Card> createCard(const std::string &cardName);
+    const Card *createCard(const std::string &cardName) const;
+
+    /**
+     * @brief Decode a bean name into its BeanId without allocating.
+     *        Dispatches on length and first character, then confirms with a single compare.
+     * @param name Pointer to the name characters (need not be null-terminated).
+     * @param length Number of characters in the name.
+     * @param bean Receives the decoded bean type on success.
+     * @return true if the name is a valid bean name, false otherwise.
+     */
+    static bool decodeBean(const char *name, std::size_t length, BeanId &bean) noexcept;
 
     /**
-     * @brief Cleanup the CardFactory instance. Resets the singleton.
+     * @brief Decode a bean name held in a string.
+     * @see decodeBean(const char *, std::size_t, BeanId &)
      */
-    static void cleanup() {
-        std::cout << "Starting CardFactory cleanup...\n";
-        instance.reset();
-        std::cout << "CardFactory cleanup complete\n";
+    static bool decodeBean(const std::string &name, BeanId &bean) noexcept {
+        return decodeBean(name.data(), name.size(), bean);
     }
 
+    /**
+     * @brief Number of cards of a bean type in the full deck.
+     * @param bean The bean type.
+     */
+    static constexpr int cardsOf(BeanId bean) { return COMPOSITION[static_cast<int>(bean)]; }
+
     ~CardFactory() {
         try {
             cards.clear();
@@ -54,21 +93,20 @@ public:
         catch (const std::exception &e) {
             std::cerr << "Error in CardFactory destructor: " << e.what() << "\n";
         }
-        std::cout << "CardFactory destructor end\n";
     }
 
 private:
     // Private constructor for the singleton
     CardFactory();
 
-    // Singleton instance
-    static std::shared_ptr<CardFactory> instance;
+    // The full card pool (NUM_CARDS bean ids), copied and shuffled for each new deck
+    std::vector<BeanId> cards;
 
-    // Map from card name to a vector of unique_ptr<Card> representing the card pool
-    std::map<std::string, std::vector<std::unique_ptr<Card>>> cards;
+    // Cards per bean type in the full deck, in BeanId order
+    static constexpr std::uint8_t COMPOSITION[NUM_BEAN_TYPES] = {20, 18, 16, 14, 12, 10, 8, 6};
 
     /**
-     * @brief Initialize the card pools with the correct number of each bean type.
+     * @brief Initialize the card pool with the correct number of each bean type.
      */
     void initializeCards();
 };
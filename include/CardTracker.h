@@ -0,0 +1,134 @@
+#ifndef CARD_TRACKER_H
+#define CARD_TRACKER_H
+
+#include <array>
+#include <cstdint>
+#include "Card.h"
+#include "GameState.h"
+#include "Journal.h"
+
+namespace card_tracker_detail {
+
+/**
+ * @brief Binomial coefficients C(n, k) for every n and k up to the size of the deck.
+ */
+struct Binomials {
+    double c[NUM_CARDS + 1][NUM_CARDS + 1];
+};
+
+/**
+ * @brief Build Pascal's triangle at compile time.
+ */
+constexpr Binomials build()
+{
+    Binomials table{};
+    for (int n = 0; n <= NUM_CARDS; ++n)
+    {
+        table.c[n][0] = 1;
+        for (int k = 1; k <= n; ++k)
+        {
+            table.c[n][k] = table.c[n - 1][k - 1] + (k < n ? table.c[n - 1][k] : 0);
+        }
+    }
+    return table;
+}
+
+} // namespace card_tracker_detail
+
+/**
+ * @brief One player's count of the cards they have not seen yet, with draw probabilities
+ * @details Starts from the full composition (CardFactory::cardsOf()) less everything the observer
+ *          can see, and follows the game through the GameEngine's change records: a card stops
+ *          being unseen when the observer draws it or it turns up face up (trade area, chains,
+ *          discard pile, or played from the opponent's hand). A card the opponent had to put back
+ *          at the front of their hand stays known until it leaves again. Each update is O(1).
+ *
+ *          The unseen cards are the deck plus the unknown part of the opponent's hand. From the
+ *          observer's side these are interchangeable, so the next k cards off the deck are a
+ *          uniformly random k of them, and the chance of drawing a bean is hypergeometric.
+ *          Probabilities are read from a binomial table built at compile time.
+ *
+ *          The tracker follows play forward only; call reset() after Journal::undo().
+ */
+class CardTracker
+{
+public:
+    /**
+     * @brief Constructs a tracker for a player of a new game, before the deal
+     * @param observer The player whose view is tracked (1 or 2)
+     * @throws std::out_of_range if observer is invalid
+     */
+    explicit CardTracker(int observer);
+
+    /** @brief Gets the player whose view is tracked (1 or 2) */
+    int getObserver() const { return observer + 1; }
+
+    /**
+     * @brief Recounts from a table, e.g. after a deal or loading a game
+     * @param state The table
+     *
+     * Assumes the observer watched the game so far: every card not in the deck or the
+     * opponent's hand has been seen, and nothing is known about the opponent's hand.
+     */
+    void reset(const GameState &state);
+
+    /**
+     * @brief Follows one change to the table
+     * @param change The change, as written by the GameEngine
+     */
+    void observe(const Journal::Record &change);
+
+    /** @brief Number of cards of a bean type the observer has not seen */
+    int unseen(BeanId bean) const { return unseenCounts[static_cast<int>(bean)]; }
+
+    /** @brief Number of cards the observer has not seen */
+    int unseenTotal() const { return totalUnseen; }
+
+    /** @brief Number of cards left in the deck */
+    int deckSize() const { return cardsInDeck; }
+
+    /**
+     * @brief Number of cards at the front of the opponent's hand whose bean is known
+     */
+    int knownInOpponentHand() const { return numKnown; }
+
+    /**
+     * @brief Probability that at least one card of a bean comes up in the next draws
+     * @param bean The bean type
+     * @param draws Number of cards to draw (capped at the deck size)
+     */
+    double probabilityInNext(BeanId bean, int draws) const;
+
+    /**
+     * @brief Probability that at least a number of cards of a bean come up in the next draws
+     * @param bean The bean type
+     * @param count Number of cards of that bean wanted
+     * @param draws Number of cards to draw (capped at the deck size)
+     */
+    double probabilityAtLeast(BeanId bean, int count, int draws) const;
+
+    /**
+     * @brief Expected number of cards of a bean in the next draws
+     * @param bean The bean type
+     * @param draws Number of cards to draw (capped at the deck size)
+     */
+    double expectedInNext(BeanId bean, int draws) const;
+
+private:
+    std::uint8_t observer;                                    ///< Observing player (0 or 1)
+    std::array<std::uint8_t, NUM_BEAN_TYPES> unseenCounts{}; ///< Unseen cards per bean type
+    int totalUnseen = 0;                                      ///< Unseen cards in all
+    int cardsInDeck = 0;                                      ///< Cards left in the deck
+    std::array<BeanId, NUM_CARDS> known{};                    ///< Known front of the opponent's hand, front card last
+    int numKnown = 0;                                         ///< Number of known cards
+
+    static constexpr card_tracker_detail::Binomials binomials = card_tracker_detail::build();
+
+    /** @brief Marks a card as seen */
+    void reveal(BeanId bean);
+
+    /** @brief Clamps a number of draws to what the deck and the unseen cards allow */
+    int clampDraws(int draws) const;
+};
+
+#endif // CARD_TRACKER_H
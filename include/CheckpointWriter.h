@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_WRITER_H
+#define CHECKPOINT_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.h"
+
+class Table;
+
+/**
+ * @brief Writes a table's checkpoints as a full save followed by small changes to it
+ * @details The first checkpoint, and every compactEvery-th after it, is a full
+ *          Table::saveBinary() save that becomes the base. The others are deltas against
+ *          the base that hold only the sections that changed since it. A player or the
+ *          trade area is written whole. The deck and the discard pile are written as the
+ *          number of bottom cards they share with the base and the cards above those, so a
+ *          deck that was only drawn from costs two bytes.
+ *
+ *          A delta starts with the magic number, the format version and the hash of the
+ *          base, then the current player and a byte with one bit per changed section.
+ *          Restoring takes the base and the latest delta only, never a chain of them.
+ */
+class CheckpointWriter
+{
+public:
+    static constexpr int DEFAULT_COMPACT_EVERY = 16; ///< Checkpoints per full save
+
+    /**
+     * @brief Constructs a writer with no base yet
+     * @param compactEvery A full save is written every this many checkpoints
+     * @throws std::invalid_argument if compactEvery is less than 1
+     */
+    explicit CheckpointWriter(int compactEvery = DEFAULT_COMPACT_EVERY);
+
+    /**
+     * @brief Writes a checkpoint of a table
+     * @param table The table
+     * @param out Buffer the checkpoint is appended to
+     * @return true if it is a full save, which replaces the base; false for a delta
+     * @throws std::length_error if a section does not fit the format
+     */
+    bool checkpoint(const Table &table, std::vector<std::uint8_t> &out);
+
+    /** @brief Forces the next checkpoint to be a full save */
+    void compact() { sinceBase = -1; }
+
+    /**
+     * @brief Checks if a checkpoint is a delta rather than a full save
+     * @param data First byte of the checkpoint
+     * @param size Number of bytes
+     */
+    static bool isDelta(const std::uint8_t *data, std::size_t size);
+
+    /**
+     * @brief Rebuilds a table from its last full save and a delta written against it
+     * @param base First byte of the full save
+     * @param baseSize Number of bytes in the full save
+     * @param delta First byte of the delta, nullptr to restore the full save alone
+     * @param deltaSize Number of bytes in the delta
+     * @return The table
+     * @throws std::runtime_error if either is malformed or the delta belongs to another base
+     */
+    static Table restore(const std::uint8_t *base, std::size_t baseSize, const std::uint8_t *delta,
+                         std::size_t deltaSize);
+
+private:
+    /**
+     * @brief Bit of a section in a delta's changed-section byte
+     */
+    enum Section : std::uint8_t
+    {
+        Player1 = 1 << 0,
+        Player2 = 1 << 1,
+        DeckCards = 1 << 2,
+        Discards = 1 << 3,
+        Trade = 1 << 4
+    };
+
+    static constexpr std::uint8_t MAGIC[4] = {'B', 'N', 'Z', 'D'}; ///< First bytes of a delta
+    static constexpr int VERSION = 2;                              ///< Delta format written (2: polynomial hand hash)
+
+    int compactEvery;        ///< Checkpoints per full save
+    int sinceBase = -1;      ///< Deltas written since the base, -1 before the first save
+    GameState base;          ///< The position of the last full save
+    std::uint64_t baseHash;  ///< Its hash, which ties deltas to it
+};
+
+#endif // CHECKPOINT_WRITER_H
@@ -0,0 +1,95 @@
+#ifndef CORPUS_LOADER_H
+#define CORPUS_LOADER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Table;
+
+/**
+ * @brief Loads many saved games into tables in parallel, for bulk analysis
+ * @details Each file is read with a MappedFile and parsed in place by
+ *          Table(const std::uint8_t *, std::size_t), in either save format. Workers take
+ *          files in small chunks from a shared counter, so one slow file does not hold up
+ *          the rest. Loading is strict: a file that fails to parse, or that holds more
+ *          cards of any bean than the game has, is reported as an error and never reaches
+ *          the visitor.
+ */
+class CorpusLoader
+{
+public:
+    static constexpr const char *DEFAULT_PATTERN = "savegame*"; ///< Files taken from a directory
+
+    /**
+     * @brief A file that could not be loaded
+     */
+    struct Error
+    {
+        std::string path;    ///< Path of the file
+        std::string message; ///< Why it failed
+    };
+
+    /**
+     * @brief Totals of a load
+     */
+    struct Report
+    {
+        std::size_t files = 0;     ///< Files loaded
+        std::size_t bytes = 0;     ///< Bytes read from the loaded files
+        std::size_t cards = 0;     ///< Cards on the loaded tables
+        double seconds = 0;        ///< Wall time of the load
+        std::vector<Error> errors; ///< Files that failed, in the order they were given
+    };
+
+    /**
+     * @brief Called once per loaded table, from the worker threads, in no particular order
+     * @details The arguments are the file's index in the list and its table, which the
+     *          visitor may move from. Calls overlap, so a visitor that shares state must lock it.
+     */
+    using Visitor = std::function<void(std::size_t, Table &)>;
+
+    /**
+     * @brief Constructs a loader
+     * @param threads Number of worker threads, 0 for one per core
+     */
+    explicit CorpusLoader(unsigned threads = 0);
+
+    /** @brief Number of worker threads */
+    unsigned getThreads() const { return threads; }
+
+    /**
+     * @brief Lists the saves of a corpus
+     * @param where A directory, whose files matching DEFAULT_PATTERN are taken, or a glob
+     *              pattern such as "archive/savegame*.txt"
+     * @return The paths, sorted
+     * @throws std::runtime_error if the pattern cannot be read or matches nothing
+     */
+    static std::vector<std::string> list(const std::string &where);
+
+    /**
+     * @brief Loads files, passing each table to a visitor
+     * @param paths Files to load
+     * @param visit Visitor of the loaded tables; it may be empty to only validate
+     * @return Totals and per-file errors
+     *
+     * An exception from the visitor is reported as an error of that file.
+     */
+    Report load(const std::vector<std::string> &paths, const Visitor &visit) const;
+
+    /**
+     * @brief Loads files and keeps their tables
+     * @param paths Files to load
+     * @param tables Receives the tables of the files that loaded, in the order given
+     * @return Totals and per-file errors
+     */
+    Report load(const std::vector<std::string> &paths, std::vector<Table> &tables) const;
+
+private:
+    static constexpr std::size_t CHUNK = 16; ///< Files a worker takes at a time
+
+    unsigned threads; ///< Number of worker threads
+};
+
+#endif // CORPUS_LOADER_H
@@ -1,53 +1,142 @@
 #ifndef DECK_H
 #define DECK_H
 
-#include <vector>
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include "Card.h"
+#include "GameRng.h"
+#include "Zobrist.h"
 
 class CardFactory;
+class ByteReader;
+class ByteWriter;
+class TextReader;
 
 /**
  * @brief The Deck class represents a deck of bean cards. It allows drawing from the top,
  *        adding cards, checking if empty, and serialization.
+ * @details Cards are a contiguous array of bean ids, bottom first, with a cursor marking
+ *          the top, plus a per-bean count of the cards remaining. Drawing is a cursor
+ *          decrement, and the whole deck is trivially copyable.
  */
 class Deck {
 private:
-    std::vector<std::unique_ptr<Card>> cards;
+    std::array<BeanId, NUM_CARDS> cards{};                ///< Bean ids, bottom to top
+    std::uint8_t cursor = 0;                              ///< Number of cards left; cards[cursor - 1] is the top
+    std::array<std::uint8_t, NUM_BEAN_TYPES> beanCounts{}; ///< Cards left per bean type
+    std::uint64_t hashValue = 0;                          ///< Zobrist hash of the remaining cards
+
+    /**
+     * @brief Recompute the hash from the remaining cards.
+     */
+    void rehash();
 
 public:
     Deck() = default;
 
+    /**
+     * @brief Construct a Deck from a sequence of bean ids (the last id is the top card).
+     * @param beans The cards in the deck, bottom to top.
+     * @param count Number of cards.
+     * @throws std::length_error if count exceeds NUM_CARDS.
+     */
+    Deck(const BeanId *beans, std::size_t count);
+
     /**
      * @brief Construct a Deck from an input stream, loading previously saved cards.
      * @param in Input stream containing saved deck data.
      * @param factory CardFactory used to recreate cards by name.
+     * @throws std::runtime_error if a card name is unknown or the input ends before END_DECK.
      */
     Deck(std::istream &in, const CardFactory *factory);
 
-    Deck(Deck &&) noexcept = default;
-    Deck &operator=(Deck &&) noexcept = default;
+    /**
+     * @brief Construct a Deck from a binary save.
+     * @param in Reader positioned at the deck, as writeBinary() wrote it.
+     * @throws std::runtime_error if the data is malformed.
+     */
+    explicit Deck(ByteReader &in);
 
-    Deck(const Deck &) = delete;
-    Deck &operator=(const Deck &) = delete;
+    /**
+     * @brief Construct a Deck by parsing a text save in place, like the stream constructor.
+     * @param in Reader positioned at the deck.
+     * @throws std::runtime_error if the data is malformed.
+     */
+    explicit Deck(TextReader &in);
 
     /**
      * @brief Draw the top card from the deck.
-     * @return A unique_ptr to the drawn Card.
+     * @return Pointer to the (shared) drawn Card.
      * @throws std::runtime_error if the deck is empty.
      */
-    std::unique_ptr<Card> draw();
+    const Card *draw();
+
+    /**
+     * @brief Draw up to n cards from the top straight into a hand, trade area or other
+     *        container that accepts cards through operator+=.
+     * @param n Number of cards to draw.
+     * @param out Destination of the drawn cards, in draw order.
+     * @return The number of cards actually drawn (fewer than n if the deck runs out).
+     */
+    template <typename Container>
+    std::size_t drawN(std::size_t n, Container &out) {
+        std::size_t drawn = n < cursor ? n : cursor;
+        for (std::size_t i = 0; i < drawn; ++i) {
+            BeanId bean = cards[--cursor];
+            --beanCounts[static_cast<int>(bean)];
+            hashValue ^= zobrist::key(zobrist::Part::Deck, cursor, bean);
+            out += Card::get(bean);
+        }
+        return drawn;
+    }
+
+    /**
+     * @brief Look at a card without drawing it.
+     * @param k Depth from the top (0 is the next card to be drawn).
+     * @return Pointer to the card k positions below the top.
+     * @throws std::out_of_range if the deck has k or fewer cards.
+     */
+    const Card *peek(std::size_t k = 0) const;
 
     /**
      * @brief Add a card to the deck (to the top).
      * @param card The card to add.
      * @throws std::invalid_argument if card is null.
+     * @throws std::length_error if the deck already holds NUM_CARDS cards.
+     */
+    void addCard(const Card *card);
+
+    /**
+     * @brief Shuffle the cards remaining in the deck.
+     * @param rng Generator to shuffle with.
      */
-    void addCard(std::unique_ptr<Card> card);
+    void shuffle(GameRng &rng) {
+        rng.shuffle(cards.begin(), cards.begin() + cursor);
+        rehash();
+    }
 
-    bool empty() const { return cards.empty(); }
-    size_t size() const { return cards.size(); }
+    bool empty() const { return cursor == 0; }
+    size_t size() const { return cursor; }
+
+    /**
+     * @brief Number of cards of a bean type left in the deck.
+     * @param bean The bean type.
+     */
+    int remaining(BeanId bean) const { return beanCounts[static_cast<int>(bean)]; }
+
+    /**
+     * @brief Zobrist hash of the remaining cards and their order, kept up to date as cards move.
+     */
+    std::uint64_t hash() const { return hashValue; }
+
+    /**
+     * @brief Check if the deck differs from an earlier copy, e.g. the last checkpoint.
+     * @details O(1) when the hashes differ; equal hashes are confirmed card by card.
+     * @param base The earlier copy.
+     */
+    bool changedSince(const Deck &base) const;
 
     /**
      * @brief Serialize the deck to an output stream (saving the order of cards).
@@ -55,6 +144,28 @@ public:
      */
     void serialize(std::ostream &out) const;
 
+    /**
+     * @brief Write the deck to a binary save: its size, then its beans bottom to top.
+     * @param out Writer to append to.
+     */
+    void writeBinary(ByteWriter &out) const;
+
+    /**
+     * @brief Write the deck as a change to an earlier copy: the number of bottom cards the
+     *        two share, then the cards above them. Drawing leaves only the count to write.
+     * @param out Writer to append to.
+     * @param base The earlier copy.
+     */
+    void writeDelta(ByteWriter &out, const Deck &base) const;
+
+    /**
+     * @brief Construct a Deck from an earlier copy and a change writeDelta() wrote.
+     * @param in Reader positioned at the change.
+     * @param base The copy the change was written against.
+     * @throws std::runtime_error if the data is malformed or does not fit the base.
+     */
+    Deck(ByteReader &in, const Deck &base);
+
     friend std::ostream &operator<<(std::ostream &out, const Deck &deck);
 
     ~Deck() = default;
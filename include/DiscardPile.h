@@ -1,12 +1,17 @@
 #ifndef DISCARD_PILE_H
 #define DISCARD_PILE_H
 
-#include <vector>
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include "Card.h"
+#include "Zobrist.h"
 
 class CardFactory;
+class ByteReader;
+class ByteWriter;
+class TextReader;
 
 /**
  * @class DiscardPile
@@ -14,13 +19,15 @@ class CardFactory;
  *
  * The DiscardPile class represents the pile where players discard their cards.
  * It provides functionality to add cards, pick up the top card, and view the current state.
- * The class uses RAII principles with smart pointers for memory management.
+ * Cards are stored as compact bean ids that resolve to the shared Card instances,
+ * in a fixed array sized for the whole game, so the pile is trivially copyable.
  */
 class DiscardPile
 {
 private:
-    /** @brief Vector storing the cards in the discard pile */
-    std::vector<std::unique_ptr<Card>> cards;
+    std::array<BeanId, NUM_CARDS> cards{}; ///< Bean ids, bottom to top
+    std::uint8_t count = 0;                ///< Number of cards in the pile
+    std::uint64_t hashValue = 0;           ///< Zobrist hash of the cards by position
 
 public:
     /**
@@ -32,45 +39,39 @@ public:
      * @brief Constructs a DiscardPile from saved game data
      * @param in Input stream containing serialized discard pile data
      * @param factory Pointer to the CardFactory for creating cards
+     * @throws std::runtime_error if a card name is unknown or the input ends before END_DISCARD
      */
     DiscardPile(std::istream &in, const CardFactory *factory);
 
     /**
-     * @brief Move constructor
+     * @brief Constructs a DiscardPile from a binary save
+     * @param in Reader positioned at the pile, as writeBinary() wrote it
+     * @throws std::runtime_error if the data is malformed
      */
-    DiscardPile(DiscardPile &&other) noexcept = default;
+    explicit DiscardPile(ByteReader &in);
 
     /**
-     * @brief Move assignment operator
+     * @brief Constructs a DiscardPile by parsing a text save in place, like the stream constructor
+     * @param in Reader positioned at the discard pile
+     * @throws std::runtime_error if the data is malformed
      */
-    DiscardPile &operator=(DiscardPile &&other) noexcept = default;
-
-    /**
-     * @brief Copy constructor (deleted)
-     * @details Copying is disabled because the class manages unique resources
-     */
-    DiscardPile(const DiscardPile &) = delete;
-
-    /**
-     * @brief Copy assignment operator (deleted)
-     * @details Copying is disabled because the class manages unique resources
-     */
-    DiscardPile &operator=(const DiscardPile &) = delete;
+    explicit DiscardPile(TextReader &in);
 
     /**
      * @brief Adds a card to the discard pile
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      * @return Reference to the modified DiscardPile
      * @throws std::invalid_argument if card is null
+     * @throws std::length_error if the pile already holds NUM_CARDS cards
      */
-    DiscardPile &operator+=(std::unique_ptr<Card> card);
+    DiscardPile &operator+=(const Card *card);
 
     /**
      * @brief Removes and returns the top card from the pile
-     * @return Unique pointer to the picked up card
+     * @return Pointer to the picked up card
      * @throws std::runtime_error if pile is empty
      */
-    std::unique_ptr<Card> pickUp();
+    const Card *pickUp();
 
     /**
      * @brief Returns a pointer to the top card without removing it
@@ -83,7 +84,26 @@ public:
      * @brief Checks if the discard pile is empty
      * @return true if pile contains no cards, false otherwise
      */
-    bool empty() const;
+    bool empty() const { return count == 0; }
+
+    /** @brief Number of cards in the pile */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Bean of a card in the pile
+     * @param index Position from the bottom, less than size()
+     */
+    BeanId beanAt(std::size_t index) const { return cards[index]; }
+
+    /** @brief Zobrist hash of the cards and their order, kept up to date as cards move */
+    std::uint64_t hash() const { return hashValue; }
+
+    /**
+     * @brief Checks if the pile differs from an earlier copy, e.g. the last checkpoint
+     * @details O(1) when the hashes differ; equal hashes are confirmed card by card.
+     * @param base The earlier copy
+     */
+    bool changedSince(const DiscardPile &base) const;
 
     /**
      * @brief Prints the current state of the discard pile
@@ -97,9 +117,31 @@ public:
      */
     void serialize(std::ostream &out) const;
 
+    /**
+     * @brief Writes the pile to a binary save: its size, then its beans bottom to top
+     * @param out Writer to append to
+     */
+    void writeBinary(ByteWriter &out) const;
+
+    /**
+     * @brief Writes the pile as a change to an earlier copy: the number of bottom cards the
+     *        two share, then the cards above them
+     * @param out Writer to append to
+     * @param base The earlier copy
+     */
+    void writeDelta(ByteWriter &out, const DiscardPile &base) const;
+
+    /**
+     * @brief Constructs a DiscardPile from an earlier copy and a change writeDelta() wrote
+     * @param in Reader positioned at the change
+     * @param base The copy the change was written against
+     * @throws std::runtime_error if the data is malformed or does not fit the base
+     */
+    DiscardPile(ByteReader &in, const DiscardPile &base);
+
     /**
      * @brief Default destructor
-     * @details Can be defaulted since using smart pointers
+     * @details Can be defaulted since cards are shared flyweights
      */
     ~DiscardPile() = default;
 
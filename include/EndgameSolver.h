@@ -0,0 +1,142 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.h"
+#include "MoveGen.h"
+
+/**
+ * @brief Exact expectimax search of the last turns of a game
+ * @details Solves a position with both hands known, the deck being a random order of the cards
+ *          it holds. The value of a position is the expected final margin, player 1's coins less
+ *          player 2's, when player 1 maximizes it, player 2 minimizes it and every draw is taken
+ *          over all the cards the deck could yield, weighted by their chances.
+ *
+ *          Decisions are played through GameEngine::step(). The draws are chance nodes after a
+ *          discard: the trade area fill as a multiset of three beans, the end of turn draw in
+ *          order (only while the player will play again) and the card that starts the next turn.
+ *          Draws that cannot change the result are left out, which keeps the chance nodes small:
+ *          the next cards off a shuffled deck are a uniform sample of it whichever cards before
+ *          them are skipped. A turn that starts with no more than TRADE_AREA_DRAW +
+ *          END_OF_TURN_DRAW cards in the deck is the last, and its discard ends the search.
+ *          In the last turn an action that is known to be best is searched alone: taking a trade
+ *          card for a planted chain, planting the second card, harvesting the richest field.
+ *
+ *          Values are memoized in a fixed-size transposition table allocated once, keyed on the
+ *          position's Zobrist hash with the deck hashed by its counts rather than its order.
+ *          The search itself allocates nothing. Positions are only solved while the deck holds
+ *          fewer cards than the threshold; with the default two turns at most remain.
+ */
+class EndgameSolver
+{
+public:
+    static constexpr int DEFAULT_THRESHOLD = 12;       ///< Deck size the solver starts below
+    static constexpr unsigned DEFAULT_TABLE_BITS = 18; ///< Log2 of the transposition table entries
+
+    /**
+     * @brief Constructs a solver
+     * @param threshold Positions are solved while the deck holds fewer cards than this
+     * @param tableBits Log2 of the number of transposition table entries
+     * @throws std::invalid_argument if tableBits is 0 or above 30
+     */
+    explicit EndgameSolver(int threshold = DEFAULT_THRESHOLD, unsigned tableBits = DEFAULT_TABLE_BITS);
+
+    /** @brief Gets the deck size the solver starts below */
+    int getThreshold() const { return threshold; }
+
+    /**
+     * @brief Checks if a position is small enough to solve
+     * @param state The table
+     * @return true if the deck holds fewer cards than the threshold
+     */
+    bool covers(const GameState &state) const { return static_cast<int>(state.deck.size()) < threshold; }
+
+    /**
+     * @brief Solves a decision of the current player
+     * @param state The table, with both hands known
+     * @param phase The decision
+     * @return The expected final margin for player 1
+     * @throws std::invalid_argument if the solver does not cover the position
+     */
+    double value(const GameState &state, TurnPhase phase);
+
+    /**
+     * @brief Solves a decision after one of its actions
+     * @param state The table, with both hands known
+     * @param phase The decision
+     * @param action One of the actions MoveGen::generate() lists for it
+     * @return The expected final margin for player 1
+     * @throws std::invalid_argument if the solver does not cover the position
+     */
+    double actionValue(const GameState &state, TurnPhase phase, int action);
+
+    /**
+     * @brief Finds the best action of a decision of the current player
+     * @param state The table, with both hands known
+     * @param phase The decision
+     * @param value Set to the expected final margin for player 1, unless nullptr
+     * @return The action, encoded as documented in TurnPhase; -1 if the game is over
+     * @throws std::invalid_argument if the solver does not cover the position
+     */
+    int bestAction(const GameState &state, TurnPhase phase, double *value = nullptr);
+
+    /**
+     * @brief Solves the start of the current player's turn, before their first draw
+     * @param state The table, with both hands known
+     * @return The expected final margin for player 1
+     * @throws std::invalid_argument if the solver does not cover the position
+     */
+    double turnValue(const GameState &state);
+
+    /** @brief Number of positions searched, not counting transposition table hits */
+    long long getNodes() const { return nodes; }
+
+    /** @brief Forgets every memoized value */
+    void clear();
+
+private:
+    /**
+     * @brief A memoized value
+     */
+    struct Entry
+    {
+        std::uint64_t key = 0; ///< Position key, 0 for an empty entry
+        double value = 0;      ///< Expected final margin for player 1
+    };
+
+    /** @brief The cards drawn between a discard and the next decision */
+    struct Draws;
+
+    int threshold;             ///< Deck size the solver starts below
+    std::vector<Entry> table;  ///< Transposition table, a power of two of entries
+    std::uint64_t mask;        ///< Entries - 1
+    long long nodes = 0;       ///< Positions searched
+
+    /** @brief Throws if the solver does not cover the position */
+    void check(const GameState &state) const;
+
+    /** @brief Looks up a position key, returning false if absent */
+    bool probe(std::uint64_t key, double &value) const;
+
+    /** @brief Memoizes the value of a position key */
+    void store(std::uint64_t key, double value);
+
+    /** @brief Searches a decision */
+    double search(const GameState &state, TurnPhase phase);
+
+    /** @brief Searches a decision after one of its actions */
+    double after(const GameState &state, TurnPhase phase, int action);
+
+    /** @brief Searches the draws that follow a discard */
+    double chance(const GameState &state, int action);
+
+    /** @brief Deals each bean at one draw position and searches the outcomes */
+    double deal(const GameState &discarded, Draws &draws, int position);
+
+    /** @brief Plays on to the next decision with a choice, or to a discard */
+    double settle(GameState &state, TurnPhase phase);
+};
+
+#endif // ENDGAME_SOLVER_H
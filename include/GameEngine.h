@@ -0,0 +1,281 @@
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+
+#include <array>
+#include <cstddef>
+#include "Table.h"
+#include "Journal.h"
+#include "CardTracker.h"
+#include "GameLog.h"
+#include "MoveGen.h"
+
+class Agent;
+
+/**
+ * @brief Outcome of planting the front card of a hand
+ */
+struct Planting
+{
+    const Card *card = nullptr; ///< The card taken from the front of the hand
+    bool chained = false;       ///< false if no field could take it; the card went back to the hand
+};
+
+/**
+ * @brief Runs the rules of a game on a GameState without any input or output
+ * @details Each phase of a turn is a separate step, called in this order:
+ *          drawCard(), buyThirdChain(), chainFromTradeArea(), plantFromHand() (once or twice),
+ *          harvest(), discard(), fillTradeArea(), drainDiscardPile(), drawEndOfTurn(), endTurn().
+ *          The optional steps may be skipped. Every step acts on the current player, and the
+ *          caller (the terminal front end, a bot or a simulator) decides which steps to take.
+ *          Rule violations are reported by exceptions, as elsewhere in the game.
+ *          When given a Journal, each step is recorded as one move that Journal::undo() reverses.
+ *          When given a GameLog, each step that changed the game is appended to it as an event.
+ */
+class GameEngine
+{
+public:
+    static constexpr int INITIAL_HAND_SIZE = 5; ///< Cards dealt to each player at the start
+    static constexpr int TRADE_AREA_DRAW = 3;   ///< Cards turned into the trade area each turn
+    static constexpr int END_OF_TURN_DRAW = 2;  ///< Cards drawn into the hand at the end of a turn
+    static constexpr int THIRD_CHAIN_COST = 3;  ///< Price of the third field
+
+    /**
+     * @brief Constructs an engine that plays on a game state
+     * @param state The state to step; it must outlive the engine
+     * @param journal Journal to record every step in, nullptr for none
+     */
+    explicit GameEngine(GameState &state, Journal *journal = nullptr) : state(state), journal(journal) {}
+
+    /**
+     * @brief Constructs an engine that plays on the state of a table, recording in its journal
+     * @param table The table to play on; it must outlive the engine
+     */
+    explicit GameEngine(Table &table) : state(table.getState()), journal(&table.getJournal()) {}
+
+    /**
+     * @brief Replaces the deck and deals the initial hands
+     * @param deck The shuffled deck to play with
+     * @return true if every player received a full hand
+     *
+     * Starts a new game, so the journal is cleared rather than recorded in, and trackers are reset.
+     */
+    bool deal(const Deck &deck);
+
+    /**
+     * @brief Keeps a player's card tracker up to date with every step, replacing any tracker
+     *        of the same player; deal() resets it
+     * @param tracker The tracker; it must outlive the engine
+     */
+    void track(CardTracker &tracker) { trackers[tracker.getObserver() - 1] = &tracker; }
+
+    /**
+     * @brief Appends every step from now on to a game log, replacing any log given before
+     * @param log The log, started at the current position; it must outlive the engine
+     */
+    void record(GameLog &log) { gameLog = &log; }
+
+    /** @brief Gets the state being played on */
+    GameState &getState() { return state; }
+    const GameState &getState() const { return state; }
+
+    /** @brief Gets the player whose turn it is */
+    Player &currentPlayer() { return state.current(); }
+    const Player &currentPlayer() const { return state.current(); }
+
+    /**
+     * @brief Checks if the game is over
+     * @return true once the deck is empty
+     */
+    bool isOver() const { return state.deck.empty(); }
+
+    /**
+     * @brief Draws the card that starts the turn into the current player's hand
+     * @return The drawn card, nullptr if the deck is empty
+     */
+    const Card *drawCard();
+
+    /**
+     * @brief Checks if the current player may buy a third field
+     * @return true if they have two fields and can afford the third
+     */
+    bool canBuyThirdChain() const;
+
+    /**
+     * @brief Buys a third field for the current player
+     * @throws NotEnoughCoins if the player cannot afford it
+     * @throws std::runtime_error if the player already has three fields
+     */
+    void buyThirdChain();
+
+    /**
+     * @brief Moves one card from the trade area into the current player's chains
+     * @param bean Bean type of the card to take
+     * @return The chain the card was added to
+     * @throws std::runtime_error if the trade area has no such card or no field can take it;
+     *         the trade area is left unchanged
+     */
+    const Chain_Base &chainFromTradeArea(BeanId bean);
+
+    /**
+     * @brief Plants the front card of the current player's hand
+     * @return The card and whether it was chained; an unchained card stays at the front of the hand
+     * @throws std::runtime_error if the hand is empty
+     */
+    Planting plantFromHand();
+
+    /**
+     * @brief Harvests one of the current player's chains
+     * @param chainIndex Index of the chain (0 to getMaxNumChains() - 1)
+     * @return Number of coins earned, 0 if the field is unplanted
+     * @throws std::out_of_range if chainIndex is invalid
+     */
+    int harvest(int chainIndex);
+
+    /**
+     * @brief Moves a card from the current player's hand onto the discard pile
+     * @param handIndex Index of the card in the hand
+     * @return The discarded card
+     * @throws std::out_of_range if handIndex is invalid
+     */
+    const Card *discard(int handIndex);
+
+    /**
+     * @brief Turns the top cards of the deck into the trade area
+     * @return Number of cards drawn (fewer than TRADE_AREA_DRAW if the deck runs out)
+     */
+    std::size_t fillTradeArea();
+
+    /**
+     * @brief Moves matching cards from the top of the discard pile into the trade area
+     * @return Number of cards moved
+     */
+    std::size_t drainDiscardPile();
+
+    /**
+     * @brief Draws the end of turn cards into the current player's hand
+     * @return Number of cards drawn
+     */
+    int drawEndOfTurn()
+    {
+        note(GameLog::Event::DrawEndOfTurn);
+        return drawToHand(END_OF_TURN_DRAW);
+    }
+
+    /**
+     * @brief Passes the turn to the next player
+     */
+    void endTurn();
+
+    /**
+     * @brief Plays a whole turn of the current player, asking the agent for every decision
+     * @param agent The agent of the current player
+     *
+     * Nothing is printed. A decision the rules do not allow is skipped.
+     */
+    void playTurn(Agent &agent);
+
+    /**
+     * @brief Carries out one decision and plays on to the next decision that offers a choice,
+     *        in the order of playTurn(); the steps in between (plantings, the trade area fill,
+     *        the end of turn draw, the next player's draw) are taken as they come
+     * @param phase The decision being made; set to the next one, TurnPhase::Over at the end
+     * @param action One of the actions MoveGen::generate() lists for the decision
+     */
+    void act(TurnPhase &phase, int action);
+
+    /**
+     * @brief Plays through every decision that offers a single action
+     * @param phase The decision reached; set to the next one with a choice
+     */
+    void settle(TurnPhase &phase);
+
+    /**
+     * @brief Carries out one decision and the steps up to the next decision, even one that
+     *        offers a single action
+     * @param phase The decision being made; set to the next one, TurnPhase::Over at the end
+     * @param action One of the actions MoveGen::generate() lists for the decision
+     *
+     * Only the discard draws cards: it ends the turn and draws the card that starts the next one.
+     */
+    void step(TurnPhase &phase, int action);
+
+private:
+    GameState &state; ///< The state being played on
+    Journal *journal; ///< Where steps are recorded, nullptr for none
+    std::array<CardTracker *, 2> trackers{}; ///< Trackers told about every change, per observer
+    GameLog *gameLog = nullptr;              ///< Where steps are appended, nullptr for none
+
+    /**
+     * @brief Appends a step to the game log, if any
+     */
+    void note(GameLog::Event event, int arg = 0)
+    {
+        if (gameLog)
+        {
+            gameLog->append(event, arg);
+        }
+    }
+
+    /**
+     * @brief Starts a journal move for a step
+     */
+    void beginMove()
+    {
+        if (journal)
+        {
+            journal->beginMove();
+        }
+    }
+
+    /**
+     * @brief Checks if changes are recorded anywhere, so that steps can skip collecting them
+     */
+    bool logging() const { return journal || trackers[0] || trackers[1]; }
+
+    /**
+     * @brief Records a change made to the current player or the shared cards
+     */
+    void log(Journal::Op op, BeanId bean = BeanId::Blue, int a = 0, int b = 0)
+    {
+        if (!logging())
+        {
+            return;
+        }
+        Journal::Record change{op, static_cast<std::uint8_t>(state.currentPlayer - 1), bean,
+                               static_cast<std::uint8_t>(a), static_cast<std::uint8_t>(b)};
+        if (journal)
+        {
+            journal->record(change);
+        }
+        for (CardTracker *tracker : trackers)
+        {
+            if (tracker)
+            {
+                tracker->observe(change);
+            }
+        }
+    }
+
+    /**
+     * @brief Draws cards from the deck into the back of the current player's hand
+     * @param n Number of cards to draw
+     * @return Number of cards drawn
+     */
+    int drawToHand(int n);
+
+    /**
+     * @brief Sells the current player's chain in a field
+     * @param chainIndex The field, which must be planted
+     * @return Number of coins earned
+     */
+    int harvestField(int chainIndex);
+
+    /**
+     * @brief Adds a card to the current player's chains, first harvesting a chain that cannot grow
+     * @param card The card, which must be chainable (see Player::canChain())
+     * @return The chain the card was added to
+     */
+    const Chain_Base &addToChain(const Card *card);
+};
+
+#endif // GAME_ENGINE_H
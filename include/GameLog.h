@@ -0,0 +1,128 @@
+#ifndef GAME_LOG_H
+#define GAME_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+class Table;
+
+/**
+ * @brief Append-only record of a game: the starting position, then one event per engine step
+ * @details The header is the magic number, the format version, and a two-byte length
+ *          (low byte first) followed by the starting position as a Table::saveBinary()
+ *          save. Every GameEngine step after that adds one event byte: the kind in the high
+ *          nibble and its argument (a bean or a field) in the low nibble. A discard adds a
+ *          second byte, the hand index. A whole turn is about a dozen bytes.
+ *
+ *          The deck order is part of the starting position, so the draws need no more than
+ *          their event. GameReplay rebuilds the position at any turn from the log.
+ */
+class GameLog
+{
+public:
+    /**
+     * @brief Kind of step an event records, one per public GameEngine step
+     */
+    enum class Event : std::uint8_t
+    {
+        Draw,          ///< drawCard()
+        BuyField,      ///< buyThirdChain()
+        TakeTrade,     ///< chainFromTradeArea(), argument: the bean
+        Plant,         ///< plantFromHand()
+        Harvest,       ///< harvest() of a planted field, argument: the field
+        Discard,       ///< discard(), followed by a byte with the hand index
+        FillTrade,     ///< fillTradeArea()
+        Drain,         ///< drainDiscardPile()
+        DrawEndOfTurn, ///< drawEndOfTurn()
+        EndTurn        ///< endTurn()
+    };
+
+    static constexpr int NUM_EVENTS = 10; ///< Number of kinds of event
+
+    /**
+     * @brief Starts a log by writing its header
+     * @param out Stream the log is appended to, which should be opened in binary mode;
+     *            it must outlive the log
+     * @param start The position the game goes on from
+     * @throws std::length_error if the position's save does not fit in the header
+     */
+    GameLog(std::ostream &out, const Table &start);
+
+    /**
+     * @brief Appends an event
+     * @param event The kind of step
+     * @param arg Its argument: a bean, a field or, for a discard, the hand index
+     *
+     * The stream is flushed at the end of every turn, so a log on disk is whole up to the
+     * last turn played.
+     */
+    void append(Event event, int arg = 0);
+
+    /** @brief Number of events appended */
+    std::size_t getEvents() const { return events; }
+
+private:
+    std::ostream &out;      ///< Where the log is written
+    std::size_t events = 0; ///< Events appended
+
+    friend class GameReplay;
+    static constexpr std::uint8_t MAGIC[4] = {'B', 'N', 'Z', 'L'}; ///< First bytes of a log
+    static constexpr int VERSION = 1;                              ///< Format written by GameLog
+    static constexpr std::size_t HEADER_SIZE = 7;                  ///< Magic, version and start length
+};
+
+/**
+ * @brief Rebuilds the positions of a game from its GameLog
+ * @details The log is read in place and checked up front: the header, the starting
+ *          position and the framing of every event. Positions are then rebuilt by
+ *          playing the events through a GameEngine, so a step the rules reject throws
+ *          just as it would have in the game.
+ */
+class GameReplay
+{
+public:
+    /**
+     * @brief Reads a log
+     * @param data First byte of the log; the bytes must outlive the replay
+     * @param size Number of bytes
+     * @throws std::runtime_error if the data is not a valid log
+     */
+    GameReplay(const std::uint8_t *data, std::size_t size);
+
+    /** @brief Number of turns the log covers to their end */
+    int getTurns() const { return static_cast<int>(turnEnds.size()); }
+
+    /** @brief Number of events in the log */
+    std::size_t getEvents() const { return events; }
+
+    /**
+     * @brief Rebuilds the position after a number of turns
+     * @param turn Number of turns to play, from 0 (the starting position) to getTurns()
+     * @return The table, whose journal holds the steps replayed
+     * @throws std::out_of_range if turn is out of range, or an event's index is
+     * @throws std::runtime_error if an event breaks the rules
+     */
+    Table at(int turn) const;
+
+    /**
+     * @brief Rebuilds the last position, after every event including those of an unfinished turn
+     * @throws std::out_of_range if an event's index is out of range
+     * @throws std::runtime_error if an event breaks the rules
+     */
+    Table last() const;
+
+private:
+    const std::uint8_t *start;          ///< The starting position's save
+    std::size_t startSize;              ///< Its size
+    const std::uint8_t *first;          ///< First event
+    const std::uint8_t *end;            ///< One past the last event
+    std::size_t events = 0;             ///< Number of events
+    std::vector<std::size_t> turnEnds;  ///< Offset from first past each EndTurn event
+
+    /** @brief Replays the events in a byte range onto the starting position */
+    Table replay(std::size_t length) const;
+};
+
+#endif // GAME_LOG_H
@@ -0,0 +1,110 @@
+#ifndef GAME_RNG_H
+#define GAME_RNG_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+/**
+ * @brief Counter-based, splittable random number generator used to shuffle decks.
+ * @details The n-th output of a stream is a pure function of (key, n): a SplitMix64
+ *          finalizer applied to key + n * golden ratio. A stream is therefore just
+ *          16 bytes of state, discard() is O(1), and distinct (seed, stream) pairs give
+ *          independent sequences, so each simulation thread can own its generator with
+ *          no shared state or locking. The same seed produces the same deal on every
+ *          platform, since shuffling does not go through std::shuffle or std distributions.
+ */
+class GameRng
+{
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Constructs a generator for one stream of a seed
+     * @param seed 64-bit seed that fully determines the sequence
+     * @param stream Stream number (e.g. a worker thread index); each gives an independent sequence
+     */
+    explicit GameRng(std::uint64_t seed, std::uint64_t stream = 0)
+        : key(mix(seed ^ mix(stream * GOLDEN + GOLDEN))) {}
+
+    /** @brief Smallest value operator() can return */
+    static constexpr result_type min() { return 0; }
+
+    /** @brief Largest value operator() can return */
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Returns the next 64 random bits of the stream
+     */
+    result_type operator()() { return mix(key + (++counter) * GOLDEN); }
+
+    /**
+     * @brief Skips ahead in the stream
+     * @param n Number of outputs to skip
+     */
+    void discard(std::uint64_t n) { counter += n; }
+
+    /**
+     * @brief Derives a new, independent generator from this one
+     * @return A generator keyed by the next output of this stream
+     */
+    GameRng split()
+    {
+        std::uint64_t childSeed = (*this)();
+        return GameRng(childSeed, (*this)());
+    }
+
+    /**
+     * @brief Returns a uniformly distributed value in [0, bound)
+     * @param bound Exclusive upper bound; must be greater than 0
+     */
+    std::uint64_t below(std::uint64_t bound)
+    {
+        // Reject the low values that would bias the modulo
+        std::uint64_t threshold = (0 - bound) % bound;
+        for (;;)
+        {
+            std::uint64_t r = (*this)();
+            if (r >= threshold)
+            {
+                return r % bound;
+            }
+        }
+    }
+
+    /**
+     * @brief Fisher-Yates shuffle of a random-access range
+     * @param first Iterator to the first element
+     * @param last Iterator past the last element
+     */
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last)
+    {
+        for (auto i = last - first - 1; i > 0; --i)
+        {
+            auto j = static_cast<decltype(i)>(below(static_cast<std::uint64_t>(i) + 1));
+            using std::swap;
+            swap(first[i], first[j]);
+        }
+    }
+
+    static constexpr std::uint64_t GOLDEN = 0x9E3779B97F4A7C15ull; ///< 2^64 / golden ratio
+
+    /**
+     * @brief SplitMix64 finalizer: a bijective mix turning nearby inputs into unrelated outputs
+     * @param z Value to mix
+     */
+    static constexpr std::uint64_t mix(std::uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+
+    std::uint64_t key;         ///< Stream key derived from (seed, stream)
+    std::uint64_t counter = 0; ///< Number of outputs drawn so far
+};
+
+#endif // GAME_RNG_H
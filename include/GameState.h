@@ -0,0 +1,93 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "Player.h"
+#include "Deck.h"
+#include "DiscardPile.h"
+#include "TradeArea.h"
+#include "Zobrist.h"
+
+/**
+ * @brief Everything that decides how a game continues: both players, the deck, the discard pile,
+ *        the trade area and whose turn it is.
+ * @details Every part stores bean ids and small counters inline, so a GameState is a few hundred
+ *          bytes with no pointers, and copying one is a memcpy. Search and rollouts copy states
+ *          freely; the GameEngine steps them directly. A Table is a GameState plus the players'
+ *          names, and converts to and from one with Table::getState() and Table(const GameState &, ...).
+ */
+struct GameState
+{
+    std::array<Player, 2> players; ///< Player 1 and player 2
+    Deck deck;                     ///< Draw pile
+    DiscardPile discardPile;       ///< Discard pile
+    TradeArea tradeArea;           ///< Face-up cards on offer
+    std::uint8_t currentPlayer = 1; ///< Player whose turn it is (1 or 2)
+
+    /**
+     * @brief Gets a player by number
+     * @param playerNum Player number (1 or 2)
+     * @throws std::out_of_range if playerNum is invalid
+     */
+    Player &getPlayer(int playerNum)
+    {
+        validatePlayerNum(playerNum);
+        return players[playerNum - 1];
+    }
+
+    const Player &getPlayer(int playerNum) const
+    {
+        validatePlayerNum(playerNum);
+        return players[playerNum - 1];
+    }
+
+    /** @brief Gets the player whose turn it is */
+    Player &current() { return players[currentPlayer - 1]; }
+    const Player &current() const { return players[currentPlayer - 1]; }
+
+    /** @brief Advances to the next player's turn */
+    void nextPlayer() { currentPlayer = static_cast<std::uint8_t>(currentPlayer % 2 + 1); }
+
+    /**
+     * @brief Zobrist hash of the position, for transposition tables and repetition checks
+     * @details Each part keeps its own hash up to date as it changes, so this only combines
+     *          them. Player 2's hash is mixed first so that swapping the players' positions
+     *          changes the result.
+     */
+    std::uint64_t hash() const
+    {
+        return playerHash(1) ^ playerHash(2) ^ deck.hash() ^ discardPile.hash() ^ tradeArea.hash() ^
+               zobrist::key(zobrist::Part::Turn, currentPlayer);
+    }
+
+    /**
+     * @brief A player's term of hash(), e.g. to XOR the player out of a key built from it
+     * @param playerNum Player number (1 or 2)
+     */
+    std::uint64_t playerHash(int playerNum) const
+    {
+        return playerNum == 1 ? players[0].hash() : GameRng::mix(players[1].hash());
+    }
+
+    /**
+     * @brief Validates a player number
+     * @param playerNum Player number to validate
+     * @throws std::out_of_range if playerNum is not 1 or 2
+     */
+    static void validatePlayerNum(int playerNum)
+    {
+        if (playerNum < 1 || playerNum > 2)
+        {
+            throw std::out_of_range("Invalid player number: " +
+                                    std::to_string(playerNum) + ". Must be 1 or 2.");
+        }
+    }
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be copyable with memcpy");
+
+#endif // GAME_STATE_H
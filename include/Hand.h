@@ -1,16 +1,31 @@
 #ifndef HAND_H
 #define HAND_H
 
-#include <list>
-#include <memory>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include "Card.h"
+#include "Zobrist.h"
 
 class CardFactory;
-
+class ByteReader;
+class ByteWriter;
+class TextReader;
+
+/**
+ * @class Hand
+ * @brief A player's hand, kept in the order the cards must be played
+ *
+ * Cards are stored as bean ids in a fixed-capacity ring buffer, so playing from the
+ * front, adding to either end and indexed access are all O(1), and removing a card
+ * from the middle only shifts bytes on the shorter side.
+ */
 class Hand
 {
 public:
+    /** @brief Maximum number of cards a hand can hold (a power of two, at least NUM_CARDS) */
+    static constexpr int CAPACITY = 128;
+
     /**
      * @brief Default constructor creates an empty hand
      */
@@ -20,9 +35,24 @@ public:
      * @brief Constructs a Hand from saved game data
      * @param in Input stream containing serialized hand data
      * @param factory Pointer to the CardFactory for creating cards
+     * @throws std::runtime_error if a card name is unknown or the input ends before END_HAND
      */
     Hand(std::istream &in, const CardFactory *factory);
 
+    /**
+     * @brief Constructs a Hand from a binary save
+     * @param in Reader positioned at the hand, as writeBinary() wrote it
+     * @throws std::runtime_error if the data is malformed
+     */
+    explicit Hand(ByteReader &in);
+
+    /**
+     * @brief Constructs a Hand by parsing a text save in place, like the stream constructor
+     * @param in Reader positioned at the hand
+     * @throws std::runtime_error if the data is malformed
+     */
+    explicit Hand(TextReader &in);
+
     /**
      * @brief Move constructor
      */
@@ -34,30 +64,31 @@ public:
     Hand &operator=(Hand &&) noexcept = default;
 
     /**
-     * @brief Copy constructor (deleted)
-     * @details Copying is disabled because the class manages unique resources
+     * @brief Copy constructor
+     * @details A hand is a flat array of bean ids, so copying is a memcpy
      */
-    Hand(const Hand &) = delete;
+    Hand(const Hand &) = default;
 
     /**
-     * @brief Copy assignment operator (deleted)
-     * @details Copying is disabled because the class manages unique resources
+     * @brief Copy assignment operator
      */
-    Hand &operator=(const Hand &) = delete;
+    Hand &operator=(const Hand &) = default;
 
     /**
      * @brief Adds a card to the hand
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      * @return Reference to the modified Hand
+     * @throws std::invalid_argument if card is null
+     * @throws std::length_error if the hand is full
      */
-    Hand &operator+=(std::unique_ptr<Card> card);
+    Hand &operator+=(const Card *card);
 
     /**
      * @brief Plays and removes the first card from the hand
-     * @return Unique pointer to the played card
+     * @return Pointer to the played card
      * @throws std::runtime_error if hand is empty
      */
-    std::unique_ptr<Card> play();
+    const Card *play();
 
     /**
      * @brief Returns a pointer to the first card without removing it
@@ -69,28 +100,64 @@ public:
     /**
      * @brief Removes and returns the card at the specified index
      * @param index Position of the card to remove (0-based)
-     * @return Unique pointer to the removed card
+     * @return Pointer to the removed card
      * @throws std::out_of_range if index is invalid
      */
-    std::unique_ptr<Card> operator[](int index);
+    const Card *operator[](int index);
 
     /**
      * @brief Adds a card to the front of the hand
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
+     * @throws std::invalid_argument if card is null
+     * @throws std::length_error if the hand is full
+     */
+    void addToFront(const Card *card);
+
+    /**
+     * @brief Inserts a card at the specified index, undoing operator[]
+     * @param index Position the card will have (0 to size())
+     * @param card Pointer to the card to insert
+     * @throws std::invalid_argument if card is null
+     * @throws std::out_of_range if index is greater than size()
+     * @throws std::length_error if the hand is full
+     */
+    void insert(int index, const Card *card);
+
+    /**
+     * @brief Returns the card at the specified index without removing it
+     * @param index Position of the card (0-based, 0 is the front)
+     * @return Pointer to the card
+     * @throws std::out_of_range if index is invalid
+     */
+    const Card *peek(int index) const;
+
+    /**
+     * @brief Returns the bean at the specified index, without bounds checking
+     * @param index Position of the card, must be less than size()
+     * @return The card's bean id
      */
-    void addToFront(std::unique_ptr<Card> card);
+    BeanId beanAt(int index) const { return cards[slot(index)]; }
 
     /**
      * @brief Checks if the hand is empty
      * @return true if hand contains no cards, false otherwise
      */
-    bool empty() const { return cards.empty(); }
+    bool empty() const { return count == 0; }
 
     /**
      * @brief Gets the number of cards in the hand
      * @return Current number of cards
      */
-    size_t size() const { return cards.size(); }
+    size_t size() const { return count; }
+
+    /**
+     * @brief Hash of the cards and their order
+     * @details A polynomial hash: the sum of each card's key times an odd multiplier to the
+     *          power of the number of cards behind it, modulo 2^64. Adding or removing a card
+     *          at either end, as draws and plays do, updates it in O(1). Removing or inserting
+     *          in the middle costs as many steps as the cards it shifts.
+     */
+    std::uint64_t hash() const { return hashValue; }
 
     /**
      * @brief Serializes the hand to an output stream
@@ -98,6 +165,12 @@ public:
      */
     void serialize(std::ostream &out) const;
 
+    /**
+     * @brief Writes the hand to a binary save: its size, then its beans front to back
+     * @param out Writer to append to
+     */
+    void writeBinary(ByteWriter &out) const;
+
     /**
      * @brief Stream insertion operator for Hand
      * @param out Output stream
@@ -106,21 +179,26 @@ public:
      */
     friend std::ostream &operator<<(std::ostream &out, const Hand &hand);
 
-    /**
-     * @brief Gets a const reference to the cards in the hand
-     * @return Const reference to the list of cards
-     */
-    const std::list<std::unique_ptr<Card>> &getCards() const { return cards; }
-
     /**
      * @brief Default destructor
-     * @details Can be defaulted since using smart pointers
+     * @details Can be defaulted since cards are shared flyweights
      */
     ~Hand() = default;
 
 private:
-    /** @brief List storing the cards in the hand */
-    std::list<std::unique_ptr<Card>> cards;
+    std::array<BeanId, CAPACITY> cards{}; ///< Ring buffer of bean ids
+    std::uint8_t head = 0;                ///< Buffer index of the front card
+    std::uint8_t count = 0;               ///< Number of cards in the hand
+    std::uint64_t hashValue = 0;          ///< Polynomial hash of the cards in order
+
+    /** @brief Buffer index of the card at a hand position */
+    int slot(int index) const { return (head + index) & (CAPACITY - 1); }
+
+    /**
+     * @brief Throws if there is no room for another card
+     * @throws std::length_error if the hand is full
+     */
+    void checkCapacity() const;
 
     /**
      * @brief Validates if an index is within bounds
@@ -128,6 +206,14 @@ private:
      * @throws std::out_of_range if index is invalid
      */
     void validateIndex(int index) const;
+
+    /**
+     * @brief Sums what the cards in positions [first, last) add to the hash
+     */
+    std::uint64_t weight(int first, int last) const;
 };
 
+static_assert(Hand::CAPACITY >= NUM_CARDS && (Hand::CAPACITY & (Hand::CAPACITY - 1)) == 0,
+              "Hand capacity must be a power of two that can hold every card");
+
 #endif // HAND_H
\ No newline at end of file
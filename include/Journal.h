@@ -0,0 +1,93 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Card.h"
+
+struct GameState;
+
+/**
+ * @brief Log of reversible changes to a GameState, for make/unmake search and undo
+ * @details The GameEngine writes one record for every change it makes to the cards, chains,
+ *          coins or turn: five bytes holding what happened and the little needed to reverse it.
+ *          Records are grouped into moves, one per engine step. undo() reverses whole moves,
+ *          newest first, bringing the state back to exactly where it was without any snapshot.
+ */
+class Journal
+{
+public:
+    /**
+     * @brief Kind of change a record reverses
+     */
+    enum class Op : std::uint8_t
+    {
+        DrawToHand,     ///< Top card of the deck went to the back of the hand
+        PlayFromHand,   ///< Front card of the hand was taken
+        AddToFront,     ///< Card went back to the front of the hand
+        RemoveFromHand, ///< Card was taken from the hand at index a
+        TakeFromTrade,  ///< Card was taken from the trade area
+        DeckToTrade,    ///< Top card of the deck went to the trade area
+        Discard,        ///< Card went onto the discard pile
+        DiscardToTrade, ///< Top card of the discard pile went to the trade area
+        Harvest,        ///< Chain in slot a with b cards was sold
+        AddToChain,     ///< Card was added to the chain in slot a
+        BuyField,       ///< Third field was bought
+        NextPlayer      ///< Turn passed to the other player
+    };
+
+    /**
+     * @brief One reversible change
+     */
+    struct Record
+    {
+        Op op;              ///< Kind of change
+        std::uint8_t player; ///< Player affected (0 or 1)
+        BeanId bean;        ///< Bean type of the card moved, harvested or chained
+        std::uint8_t a;     ///< Hand index or chain slot
+        std::uint8_t b;     ///< Chain length harvested
+    };
+
+    /**
+     * @brief Starts a new move; later records belong to it until the next call
+     */
+    void beginMove() { marks.push_back(static_cast<std::uint32_t>(records.size())); }
+
+    /**
+     * @brief Appends a record to the current move
+     */
+    void record(const Record &change) { records.push_back(change); }
+
+    /**
+     * @brief Reverses the most recent moves
+     * @param state The state the moves were made on
+     * @param n Number of moves to reverse
+     * @return Number of moves reversed (fewer than n if the journal runs out)
+     */
+    int undo(GameState &state, int n = 1);
+
+    /** @brief Number of moves that can be undone */
+    std::size_t moves() const { return marks.size(); }
+
+    /** @brief Number of records kept */
+    std::size_t size() const { return records.size(); }
+
+    /** @brief Forgets every move, e.g. after loading or dealing a new game */
+    void clear()
+    {
+        records.clear();
+        marks.clear();
+    }
+
+private:
+    std::vector<Record> records;      ///< Changes, oldest first
+    std::vector<std::uint32_t> marks; ///< Index of the first record of each move
+
+    /**
+     * @brief Reverses a single record
+     */
+    static void revert(GameState &state, const Record &change);
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,57 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A read-only view of a whole file's bytes
+ * @details On POSIX systems a file of MAP_THRESHOLD bytes or more is memory-mapped, so
+ *          opening it copies nothing and its pages are read on first touch. A smaller file,
+ *          such as a single save, is read with one read() call instead: mapping and unmapping
+ *          it costs more system time than copying its few hundred bytes. Elsewhere every file
+ *          is read into a buffer. The view stays valid for the lifetime of the object.
+ */
+class MappedFile
+{
+public:
+    static constexpr std::size_t MAP_THRESHOLD = 64 * 1024; ///< Smallest file that is mapped
+
+    /**
+     * @brief Maps a file
+     * @param path Path of the file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string &path);
+
+    /** @brief Unmaps the file */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /** @brief Move constructor; the source is left empty */
+    MappedFile(MappedFile &&other) noexcept;
+
+    /** @brief Move assignment; the source is left empty */
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /** @brief First byte of the file */
+    const std::uint8_t *data() const { return bytes; }
+
+    /** @brief Number of bytes in the file */
+    std::size_t size() const { return length; }
+
+private:
+    const std::uint8_t *bytes = nullptr; ///< The file's bytes
+    std::size_t length = 0;              ///< Number of bytes
+    bool mapped = false;                 ///< Whether bytes is a mapping to release
+    std::vector<std::uint8_t> buffer;    ///< The bytes, where files are read rather than mapped
+
+    /** @brief Releases the mapping, leaving the object empty */
+    void release() noexcept;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,94 @@
+#ifndef MCTS_AGENT_H
+#define MCTS_AGENT_H
+
+#include <chrono>
+#include <cstdint>
+#include "Agent.h"
+#include "EndgameSolver.h"
+#include "MoveGen.h"
+
+/**
+ * @brief Settings of an MctsAgent's search
+ * @details The search of a decision stops when the time budget runs out or every thread has run
+ *          its iterations, whichever comes first; a zero disables that limit.
+ *
+ *          Near the end of the game decisions are solved exactly instead. The default threshold
+ *          solves the last turn, which is instant; 12 also solves the turn before it, taking
+ *          tens of milliseconds per sampled opponent hand.
+ */
+struct MctsSettings
+{
+    unsigned threads = 1;                  ///< Independent searches run in parallel, one per thread
+    std::chrono::milliseconds budget{50}; ///< Thinking time per decision
+    long long iterations = 0;              ///< Iterations per thread and decision
+    double exploration = 0.7;              ///< UCB exploration constant
+    int endgameThreshold = 6;              ///< Deck size below which an EndgameSolver decides, 0 for never
+    int endgameDeals = 8;                  ///< Opponent hands the solver averages over
+};
+
+/**
+ * @brief Computer player using information-set Monte Carlo tree search
+ * @details Every decision is searched from the current table as the agent's player sees it.
+ *          Each iteration determinizes the hidden cards, i.e. deals the unseen cards (the deck
+ *          and the opponent's hand) at random into a deck order and an opponent hand of the
+ *          right sizes, then descends a single tree shared by all determinizations (SO-ISMCTS):
+ *          children are chosen by UCB1 over the actions legal in that determinization, with
+ *          availability counts in place of the parent's visits. Below the tree the game is played
+ *          out by GreedyAgent, and the result (win, tie or loss) is backed up for the player who
+ *          made each move.
+ *
+ *          Searches are root-parallel: each thread grows its own tree from its own random
+ *          stream, and the visit counts at the roots are summed to pick the move. Decisions
+ *          with a single legal action are answered without searching.
+ *
+ *          Once the deck is below MctsSettings::endgameThreshold, the tree search gives way to an
+ *          EndgameSolver: the opponent's hand is dealt at random endgameDeals times, each deal is
+ *          solved exactly, and the action with the best average final margin is played.
+ */
+class MctsAgent : public Agent
+{
+public:
+    /**
+     * @brief Constructs an agent
+     * @param rng Generator for the determinizations; give each agent its own stream
+     * @param settings Search limits and parameters
+     * @throws std::invalid_argument if the settings set no limit or no thread
+     */
+    explicit MctsAgent(const GameRng &rng, const MctsSettings &settings = MctsSettings());
+
+    bool buyThirdChain(const GameEngine &engine) override;
+    bool chooseTradeBean(const GameEngine &engine, BeanId &bean) override;
+    bool playSecondCard(const GameEngine &engine) override;
+    int chooseChainToHarvest(const GameEngine &engine) override;
+    int chooseCardToDiscard(const GameEngine &engine) override;
+
+    /** @brief Gets the search settings */
+    const MctsSettings &getSettings() const { return settings; }
+
+    /** @brief Iterations run for the last decision, over all threads; deals solved in the endgame */
+    long long lastIterations() const { return iterations; }
+
+private:
+    GameRng rng;            ///< Source of the threads' random streams
+    MctsSettings settings;  ///< Search limits and parameters
+    long long iterations = 0; ///< Iterations run for the last decision
+    EndgameSolver solver;     ///< Solver of the last turns, keeping its table for the whole game
+
+    /**
+     * @brief Searches a decision and returns the action with the most visits
+     * @param state The table as it is
+     * @param phase The decision being asked
+     * @return The action, encoded as documented in TurnPhase
+     */
+    int decide(const GameState &state, TurnPhase phase);
+
+    /**
+     * @brief Solves a decision of the endgame over random deals of the opponent's hand
+     * @param state The table as it is
+     * @param phase The decision being asked
+     * @return The action with the best average final margin
+     */
+    int solveEndgame(const GameState &state, TurnPhase phase);
+};
+
+#endif // MCTS_AGENT_H
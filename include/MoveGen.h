@@ -0,0 +1,122 @@
+#ifndef MOVE_GEN_H
+#define MOVE_GEN_H
+
+#include <array>
+#include <cstdint>
+#include "GameState.h"
+
+/** @brief Set of bean types: bit b stands for the BeanId with value b */
+using BeanMask = std::uint16_t;
+
+static_assert(NUM_BEAN_TYPES <= 16, "BeanMask needs a bit per bean type");
+
+/** @brief The BeanMask holding a single bean type */
+constexpr BeanMask beanBit(BeanId bean) { return static_cast<BeanMask>(1u << static_cast<int>(bean)); }
+
+/**
+ * @brief The decisions of a turn, in the order GameEngine::playTurn() asks them
+ * @details Each decision's actions are small integers:
+ *          - BuyField, PlantSecond: 0 for no, 1 for yes
+ *          - TakeTrade: the BeanId of the card to take, -1 to stop taking
+ *          - Harvest: the index of the field, -1 to harvest nothing
+ *          - Discard: the index of the hand card, -1 to discard nothing
+ */
+enum class TurnPhase : std::uint8_t
+{
+    BuyField,    ///< Buy a third field
+    TakeTrade,   ///< Take a trade area card into a chain
+    PlantSecond, ///< Plant the next card of the hand
+    Harvest,     ///< Harvest a field
+    Discard,     ///< Discard a hand card
+    Over         ///< The game has ended; there is nothing to decide
+};
+
+/**
+ * @brief Fixed-capacity list of the actions of one decision, kept on the stack
+ */
+class MoveList
+{
+public:
+    /** @brief Most actions a decision can have: "no" plus every card of a full hand */
+    static constexpr int CAPACITY = Hand::CAPACITY + 1;
+
+    /** @brief Appends an action */
+    void push(int action) noexcept { moves[count++] = static_cast<std::int8_t>(action); }
+
+    /** @brief Removes every action */
+    void clear() noexcept { count = 0; }
+
+    /** @brief Number of actions */
+    int size() const noexcept { return count; }
+
+    /** @brief Gets an action by position */
+    int operator[](int i) const noexcept { return moves[i]; }
+
+    const std::int8_t *begin() const noexcept { return moves.data(); }
+    const std::int8_t *end() const noexcept { return moves.data() + count; }
+
+private:
+    std::array<std::int8_t, CAPACITY> moves; ///< Actions, in generation order
+    int count = 0;                           ///< Number of actions
+};
+
+/**
+ * @brief Lists the legal actions of the current player without trying them
+ * @details The engine reports an illegal move by throwing, which is the right answer for a
+ *          person at the terminal but far too slow to discover legality in a search that asks
+ *          millions of times. Every question here is answered from a few array lookups, with
+ *          no exceptions and no allocations, and the answers are the exact conditions under
+ *          which the matching GameEngine step succeeds.
+ */
+class MoveGen
+{
+public:
+    /**
+     * @brief Checks if a player may buy a third field
+     * @return true if they have two fields and can afford the third (see GameEngine::buyThirdChain())
+     */
+    static bool canBuyField(const Player &player) noexcept;
+
+    /** @brief Bean types the player has a chain of */
+    static BeanMask plantedBeans(const Player &player) noexcept;
+
+    /**
+     * @brief Bean types a card of which the player could chain right now: every bean when a
+     *        field is unplanted, otherwise the planted ones (see Player::canChain())
+     */
+    static BeanMask chainableBeans(const Player &player) noexcept;
+
+    /**
+     * @brief Trade area beans the current player can take (see GameEngine::chainFromTradeArea())
+     */
+    static BeanMask tradeMoves(const GameState &state) noexcept;
+
+    /**
+     * @brief Checks if the front card of the hand would be chained by GameEngine::plantFromHand()
+     *        rather than returned to the hand; false for an empty hand
+     */
+    static bool canPlantFront(const Player &player) noexcept;
+
+    /** @brief Planted fields, bit i for field i; these are the fields worth harvesting */
+    static std::uint8_t harvestMoves(const Player &player) noexcept;
+
+    /**
+     * @brief Number of cards that can be discarded; the valid indices are 0 to the result - 1
+     */
+    static int discardMoves(const Player &player) noexcept;
+
+    /** @brief Bean types in the player's hand */
+    static BeanMask handBeans(const Player &player) noexcept;
+
+    /**
+     * @brief Lists every legal action of a decision of the current player
+     * @param state The table
+     * @param phase The decision
+     * @param moves Set to the actions, encoded as documented in TurnPhase; the "no" action
+     *              (0 or -1) comes first and is always legal, except when the game is over
+     * @return Number of actions
+     */
+    static int generate(const GameState &state, TurnPhase phase, MoveList &moves) noexcept;
+};
+
+#endif // MOVE_GEN_H
@@ -2,11 +2,13 @@
 #define PLAYER_H
 
 #include <string>
-#include <vector>
-#include <memory>
+#include <array>
+#include <cstdint>
 #include "Hand.h"
 #include "Chain.h"
 
+class Deck;
+
 /**
  * @brief Exception thrown when a player cannot afford to buy a third chain
  */
@@ -28,26 +30,40 @@ public:
  * @brief Represents a player in the bean trading card game
  * @details The Player class manages a player's hand, chains of cards, and coins.
  *          It handles all player-specific operations including chain management,
- *          card playing, and coin transactions.
+ *          card playing, and coin transactions. The player's name is kept by the Table,
+ *          so a Player is plain game data and trivially copyable.
  */
 class Player
 {
 public:
     /**
-     * @brief Constructs a new player with the given name
-     * @param name The player's name
+     * @brief Constructs a new player with no cards, no coins and two empty fields
      */
-    Player(const std::string &name);
+    Player();
 
     /**
      * @brief Constructs a player from a saved game state
-     * @param in Input stream containing the saved state
+     * @param in Input stream positioned after the player's name
      * @param factory Pointer to the card factory for card creation
+     * @throws std::runtime_error if the data is malformed or breaks the rules a binary save
+     *         keeps: one field per bean, bounded chains and coins
      */
     Player(std::istream &in, const CardFactory *factory);
 
-    /** @brief Gets the player's name */
-    std::string getName() const { return name; }
+    /**
+     * @brief Constructs a player from a binary save
+     * @param in Reader positioned at the player, as writeBinary() wrote it
+     * @throws std::runtime_error if the data is malformed
+     */
+    explicit Player(ByteReader &in);
+
+    /**
+     * @brief Constructs a player by parsing a text save in place, like the stream constructor
+     * @param in Reader positioned after the player's name
+     * @throws std::runtime_error if the data is malformed or breaks the rules a binary save
+     *         keeps: one field per bean, bounded chains and coins
+     */
+    explicit Player(TextReader &in);
 
     /** @brief Gets the number of coins the player has */
     int getNumCoins() const { return coins; }
@@ -56,18 +72,19 @@ public:
      * @brief Gets the maximum number of chains the player can have
      * @return 3 if player has bought third chain, otherwise 2
      */
-    int getMaxNumChains() const { return (chains.size() >= 3) ? 3 : 2; }
+    int getMaxNumChains() const { return numFields; }
 
     /** @brief Gets the current number of active chains */
     int getNumChains() const;
 
     /**
      * @brief Accesses a chain by index
-     * @param i Index of the chain to access
-     * @return Reference to the chain at the given index
+     * @param i Index of the chain to access (0 to getMaxNumChains() - 1)
+     * @return Reference to the chain at the given index; an unplanted field is an empty chain
      * @throws std::out_of_range if index is invalid
+     * @note Chains are read-only from outside; they change through the Player so that its
+     *       hash stays in step with them.
      */
-    Chain_Base &operator[](int i);
     const Chain_Base &operator[](int i) const;
 
     /**
@@ -78,31 +95,42 @@ public:
 
     /**
      * @brief Adds a card to the player's hand
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      */
-    void addToHand(std::unique_ptr<Card> card) { hand += std::move(card); }
+    void addToHand(const Card *card) { hand += card; }
+
+    /**
+     * @brief Draws cards from the top of a deck straight into the player's hand
+     * @param deck The deck to draw from
+     * @param n Number of cards to draw
+     * @return Number of cards drawn (fewer than n if the deck runs out)
+     */
+    int drawToHand(Deck &deck, int n);
 
     /** @brief Plays the top card from the player's hand */
-    std::unique_ptr<Card> playFromHand() { return hand.play(); }
+    const Card *playFromHand() { return hand.play(); }
 
     /**
      * @brief Gets a card from the player's hand at specified index
      * @param index Index of the card to retrieve
-     * @return Unique pointer to the card
+     * @return Pointer to the card
      */
-    std::unique_ptr<Card> getCardFromHand(int index) { return hand[index]; }
+    const Card *getCardFromHand(int index) { return hand[index]; }
 
     /** @brief Gets the top card from the player's hand without removing it */
     const Card *getTopCardFromHand() const { return hand.top(); }
 
+    /** @brief Gets the player's hand for inspection */
+    const Hand &getHand() const { return hand; }
+
     /** @brief Checks if the player's hand is empty */
     bool isHandEmpty() const { return hand.empty(); }
 
     /**
      * @brief Adds a card to the front of the player's hand
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      */
-    void addToFrontOfHand(std::unique_ptr<Card> card);
+    void addToFrontOfHand(const Card *card);
 
     /**
      * @brief Adds coins to the player's total
@@ -112,30 +140,52 @@ public:
     Player &operator+=(int additionalCoins);
 
     /**
-     * @brief Harvests a chain of specific card type
-     * @tparam T Type of card in the chain
-     * @return Number of coins earned from harvesting
+     * @brief Finds the planted chain of a bean type
+     * @param bean Bean type to find the chain for
+     * @return Pointer to the chain, nullptr if no field holds that bean
+     */
+    const Chain_Base *findChain(BeanId bean) const
+    {
+        int slot = slotOf[static_cast<int>(bean)];
+        return slot < 0 ? nullptr : &chains[slot];
+    }
+
+    /**
+     * @brief Finds the field holding the chain of a bean type
+     * @param bean Bean type to find the chain for
+     * @return Index of the chain (for operator[]), -1 if no field holds that bean
      */
+    int getChainIndex(BeanId bean) const { return slotOf[static_cast<int>(bean)]; }
+
+    /**
+     * @brief Harvests the chain of a bean type
+     * @param bean Bean type of the chain
+     * @return Number of coins earned from harvesting, 0 if no such chain
+     */
+    int harvestChain(BeanId bean);
+
+    /**
+     * @brief Checks whether a card of a bean type could be chained right now
+     * @param bean Bean type of the card
+     * @return true if the player has a chain of that type or an unplanted field
+     */
+    bool canChain(BeanId bean) const;
+
+    /**
+     * @brief Adds a card to the chain of its bean type, planting a new field if needed
+     * @param card Pointer to the card to add
+     * @return Reference to the chain the card was added to
+     * @throws std::runtime_error if no available chain slots
+     */
+    const Chain_Base &addCardToChain(const Card *card);
+
     /**
      * @brief Harvests a chain of specific card type
      * @tparam T Type of card in the chain
      * @return Number of coins earned from harvesting
      */
     template <typename T>
-    int harvestChain()
-    {
-        for (size_t i = 0; i < chains.size(); i++)
-        {
-            if (auto *chain = dynamic_cast<Chain<T> *>(chains[i].get()))
-            {
-                int harvestedCoins = chain->sell();
-                *this += harvestedCoins;
-                chains[i] = nullptr; // Reset the chain
-                return harvestedCoins;
-            }
-        }
-        return 0;
-    }
+    int harvestChain() { return harvestChain(T::ID); }
 
     /**
      * @brief Finds a chain of specific card type
@@ -143,20 +193,7 @@ public:
      * @return Pointer to the found chain, nullptr if not found
      */
     template <typename T>
-    Chain<T> *findChainOfType()
-    {
-        for (auto &chain : chains)
-        {
-            if (chain)
-            {
-                if (auto typedChain = dynamic_cast<Chain<T> *>(chain.get()))
-                {
-                    return typedChain;
-                }
-            }
-        }
-        return nullptr;
-    }
+    const Chain_Base *findChainOfType() const { return findChain(T::ID); }
 
     /**
      * @brief Determines if a chain should be harvested
@@ -164,28 +201,12 @@ public:
      * @return true if chain should be harvested, false otherwise
      */
     template <typename T>
-    bool shouldHarvestChain()
+    bool shouldHarvestChain() const
     {
-        if (auto chain = findChainOfType<T>())
+        if (const Chain_Base *chain = findChain(T::ID))
         {
-            if (const Card *firstCard = chain->getFirstCard())
-            {
-                if (const T *typedCard = dynamic_cast<const T *>(firstCard))
-                {
-                    // Get maximum cards per coin value for this type
-                    int maxCards = 0;
-                    for (int coins = 4; coins > 0; --coins)
-                    {
-                        int cardsNeeded = typedCard->getCardsPerCoin(coins);
-                        if (cardsNeeded > 0)
-                        {
-                            maxCards = cardsNeeded;
-                            break;
-                        }
-                    }
-                    return (maxCards > 0 && chain->size() >= maxCards);
-                }
-            }
+            // A chain that can no longer earn another coin is at its maximum value
+            return Beanometer::lookup<T>(chain->size()).cardsToNextCoin == 0;
         }
         return false;
     }
@@ -193,37 +214,19 @@ public:
     /**
      * @brief Adds a card to a chain of matching type
      * @tparam T Type of card to add
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      * @return Reference to the chain the card was added to
+     * @throws IllegalType if the card is not a T
      * @throws std::runtime_error if no available chain slots
      */
     template <typename T>
-    Chain<T> &addCardToChain(std::unique_ptr<Card> card)
+    const Chain_Base &addCardToChain(const Card *card)
     {
-        // Check if current chain should be harvested
-        if (shouldHarvestChain<T>())
-        {
-            harvestChain<T>();
-        }
-
-        // Try to find existing chain or create new one
-        if (auto existingChain = findChainOfType<T>())
-        {
-            *existingChain += std::move(card);
-            return *existingChain;
-        }
-
-        // Look for empty slot
-        for (auto &chain : chains)
+        if (!card || card->getId() != T::ID)
         {
-            if (!chain)
-            {
-                chain = std::make_unique<Chain<T>>();
-                *chain += std::move(card);
-                return *dynamic_cast<Chain<T> *>(chain.get());
-            }
+            throw IllegalType();
         }
-        throw std::runtime_error("No available chain slots");
+        return addCardToChain(card);
     }
 
     /**
@@ -234,27 +237,101 @@ public:
     void printHand(std::ostream &out, bool all) const;
 
     /**
-     * @brief Serializes the player's state
+     * @brief Serializes the player's state (everything but the name)
      * @param out Output stream to serialize to
      */
     void serialize(std::ostream &out) const;
 
     /**
-     * @brief Outputs the player's state to a stream
+     * @brief Writes the player's state (everything but the name) to a binary save
+     * @param out Writer to append to
+     * @throws std::length_error if the coins or a chain do not fit in the format
+     */
+    void writeBinary(ByteWriter &out) const;
+
+    /**
+     * @brief Zobrist hash of the player's coins, fields, chains and hand
+     * @details Kept up to date as the player changes, so reading it is O(1).
+     */
+    std::uint64_t hash() const { return hashValue ^ hand.hash(); }
+
+    /**
+     * @brief Checks if the player differs from an earlier copy, e.g. the last checkpoint
+     * @details O(1) when the hashes differ; equal hashes are confirmed field by field.
+     * @param base The earlier copy
+     * @return true if the coins, fields, chains or hand differ
+     */
+    bool changedSince(const Player &base) const;
+
+    /**
+     * @brief Outputs the player's coins and chains to a stream
      * @param out Output stream
      * @param player Player to output
      * @return Reference to the output stream
      */
     friend std::ostream &operator<<(std::ostream &out, const Player &player);
 
+    /** @brief The journal reverses changes to the player's fields and coins directly */
+    friend class Journal;
+
     /** @brief Default destructor */
     ~Player() = default;
 
 private:
-    std::string name;                                ///< Player's name
-    int coins = 0;                                   ///< Number of coins the player has
-    Hand hand;                                       ///< Player's hand of cards
-    std::vector<std::unique_ptr<Chain_Base>> chains; ///< Player's card chains
+    int coins = 0;                                 ///< Number of coins the player has
+    Hand hand;                                     ///< Player's hand of cards
+    std::array<Chain_Base, 3> chains;              ///< Inline field slots; empty chain = unplanted
+    int numFields = 2;                             ///< Usable slots: 2, or 3 once bought
+    std::array<std::int8_t, NUM_BEAN_TYPES> slotOf; ///< Bean -> slot holding it, -1 if none
+    std::uint64_t hashValue = 0;                   ///< Zobrist hash of coins, fields and chains
+
+    /**
+     * @brief Marks every bean as unplanted in the slot map
+     */
+    void clearSlotMap() { slotOf.fill(-1); }
+
+    /**
+     * @brief Plants a chain read from a save in an unplanted field, while loading
+     * @param field Index of the field
+     * @param chain The chain; an empty chain leaves the field unplanted
+     * @throws std::runtime_error if the chain is too long or its bean is planted in another field
+     */
+    void plantLoaded(int field, const Chain_Base &chain);
+
+    /**
+     * @brief Replaces the chain in a field, updating the hash
+     * @param slot Index of the field
+     * @param chain The new chain; an empty chain unplants the field
+     */
+    void setChain(int slot, const Chain_Base &chain)
+    {
+        hashValue ^= chains[slot].hash(slot) ^ chain.hash(slot);
+        chains[slot] = chain;
+    }
+
+    /**
+     * @brief Sets the number of coins, updating the hash
+     */
+    void setCoins(int newCoins)
+    {
+        hashValue ^= zobrist::key(zobrist::Part::Coins, coins) ^ zobrist::key(zobrist::Part::Coins, newCoins);
+        coins = newCoins;
+    }
+
+    /**
+     * @brief Sets the number of usable fields, updating the hash
+     */
+    void setNumFields(int newNumFields)
+    {
+        hashValue ^= zobrist::key(zobrist::Part::Fields, numFields) ^
+                     zobrist::key(zobrist::Part::Fields, newNumFields);
+        numFields = newNumFields;
+    }
+
+    /**
+     * @brief Recomputes the hash of coins, fields and chains from scratch
+     */
+    void rehash();
 
     /**
      * @brief Validates a chain index
@@ -2,16 +2,20 @@
 #define TABLE_H
 
 #include <array>
-#include <memory>
-#include "Player.h"
-#include "Deck.h"
-#include "DiscardPile.h"
-#include "TradeArea.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GameState.h"
+#include "Journal.h"
+
+class TextReader;
 
 /**
  * @brief Represents the game table that manages the overall state of the game
  * @details The Table class coordinates all game components including players,
  *          deck, discard pile, and trade area. It manages turn order and game flow.
+ *          The game itself is a GameState; the table adds the players' names and I/O.
  */
 class Table
 {
@@ -30,6 +34,56 @@ public:
      */
     Table(std::istream &in, const CardFactory *factory);
 
+    /**
+     * @brief Constructs a table from a save in memory, as saveBinary() or saveGame() wrote it
+     * @details The save is parsed in place with no per-line copies, so loading from a
+     *          MappedFile reads the file's bytes straight from the page cache.
+     * @param data First byte of the save
+     * @param size Number of bytes, which must be the whole save
+     * @throws std::runtime_error if the data is not a valid save
+     */
+    Table(const std::uint8_t *data, std::size_t size);
+
+    /**
+     * @brief Constructs a table from a game state
+     * @param state The position to play from
+     * @param player1Name The name of the first player
+     * @param player2Name The name of the second player
+     */
+    Table(const GameState &state, const std::string &player1Name, const std::string &player2Name);
+
+    /**
+     * @brief Gets the game state, e.g. to copy it for search or to restore a copy
+     */
+    GameState &getState() { return state; }
+    const GameState &getState() const { return state; }
+
+    /**
+     * @brief Gets the journal of the moves played on this table through a GameEngine
+     */
+    Journal &getJournal() { return journal; }
+    const Journal &getJournal() const { return journal; }
+
+    /**
+     * @brief Takes back the most recent moves
+     * @param n Number of moves (GameEngine steps) to take back
+     * @return Number of moves taken back
+     */
+    int undo(int n = 1) { return journal.undo(state, n); }
+
+    /**
+     * @brief Zobrist hash of the game position (names are not part of it)
+     * @return The same value for equal positions, however they were reached; O(1)
+     */
+    std::uint64_t hash() const { return state.hash(); }
+
+    /**
+     * @brief Gets a player's name
+     * @param playerNum Player number (1 or 2)
+     * @throws std::out_of_range if playerNum is invalid
+     */
+    const std::string &getPlayerName(int playerNum) const;
+
     /**
      * @brief Checks if the game has been won
      * @param winnerName Reference to store the winner's name
@@ -49,31 +103,31 @@ public:
      * @return Reference to the specified player
      * @throws std::out_of_range if playerNum is invalid
      */
-    Player &getPlayer(int playerNum);
-    const Player &getPlayer(int playerNum) const;
+    Player &getPlayer(int playerNum) { return state.getPlayer(playerNum); }
+    const Player &getPlayer(int playerNum) const { return state.getPlayer(playerNum); }
 
     /** @brief Gets the deck */
-    Deck &getDeck() { return deck; }
-    const Deck &getDeck() const { return deck; }
+    Deck &getDeck() { return state.deck; }
+    const Deck &getDeck() const { return state.deck; }
 
     /** @brief Gets the discard pile */
-    DiscardPile &getDiscardPile() { return discardPile; }
-    const DiscardPile &getDiscardPile() const { return discardPile; }
+    DiscardPile &getDiscardPile() { return state.discardPile; }
+    const DiscardPile &getDiscardPile() const { return state.discardPile; }
 
     /** @brief Gets the trade area */
-    TradeArea &getTradeArea() { return tradeArea; }
-    const TradeArea &getTradeArea() const { return tradeArea; }
+    TradeArea &getTradeArea() { return state.tradeArea; }
+    const TradeArea &getTradeArea() const { return state.tradeArea; }
 
     /**
      * @brief Gets the current player's number
      * @return Current player number (1 or 2)
      */
-    int getCurrentPlayer() const { return currentPlayer; }
+    int getCurrentPlayer() const { return state.currentPlayer; }
 
     /**
      * @brief Advances to the next player's turn
      */
-    void nextPlayer() { currentPlayer = (currentPlayer % 2) + 1; }
+    void nextPlayer() { state.nextPlayer(); }
 
     /**
      * @brief Saves the current game state
@@ -81,6 +135,32 @@ public:
      */
     void saveGame(std::ostream &out) const;
 
+    /**
+     * @brief Saves the current game state in the binary format
+     * @details A header of the magic number, the format version, the current player and
+     *          the lengths of the sections that follow: both names, both players, the deck,
+     *          the discard pile and the trade area. Numbers are single bytes and beans are
+     *          packed two to a byte, so a save is well under 100 bytes.
+     * @param out Buffer the save is appended to
+     * @throws std::length_error if a name or section is longer than 255 bytes
+     */
+    void saveBinary(std::vector<std::uint8_t> &out) const;
+
+    /**
+     * @brief Saves the current game state in the binary format
+     * @param out Output stream, which should be opened in binary mode
+     * @throws std::length_error if a name or section is longer than 255 bytes
+     */
+    void saveBinary(std::ostream &out) const;
+
+    /**
+     * @brief Checks if saved data is in the binary format rather than the text format
+     * @param data First byte of the save
+     * @param size Number of bytes
+     * @return true if the data starts with the binary magic number
+     */
+    static bool isBinary(const std::uint8_t *data, std::size_t size);
+
     /**
      * @brief Outputs the table state to a stream
      * @param out Output stream
@@ -93,18 +173,19 @@ public:
     ~Table() = default;
 
 private:
-    std::array<std::unique_ptr<Player>, 2> players; ///< Array of player pointers
-    Deck deck;                                      ///< Game deck
-    DiscardPile discardPile;                        ///< Discard pile
-    TradeArea tradeArea;                            ///< Trade area
-    int currentPlayer = 1;                          ///< Current player number (1 or 2)
+    static constexpr std::uint8_t MAGIC[4] = {'B', 'N', 'Z', 'A'}; ///< First bytes of a binary save
+    static constexpr int BINARY_VERSION = 1;                       ///< Binary format written by saveBinary()
+    static constexpr int BINARY_SECTIONS = 7;                      ///< Sections after the binary header
 
-    /**
-     * @brief Validates player number
-     * @param playerNum Player number to validate
-     * @throws std::out_of_range if playerNum is invalid
-     */
-    void validatePlayerNum(int playerNum) const;
+    std::array<std::string, 2> names; ///< Names of player 1 and player 2
+    GameState state;                  ///< Players, deck, discard pile, trade area and turn
+    Journal journal;                  ///< Moves played, for undo
+
+    /** @brief Loads a binary save, which starts with the magic number */
+    void loadBinary(const std::uint8_t *data, std::size_t size);
+
+    /** @brief Loads a text save */
+    void loadText(TextReader &in);
 };
 
 #endif // TABLE_H
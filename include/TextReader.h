@@ -0,0 +1,91 @@
+#ifndef TEXT_READER_H
+#define TEXT_READER_H
+
+#include <cstddef>
+#include <cstring>
+#include "Card.h"
+
+/**
+ * @brief A line of a text save: a pointer into the save's bytes and a length, never a copy
+ */
+struct TextSpan
+{
+    const char *data = nullptr; ///< First character
+    std::size_t size = 0;       ///< Number of characters
+
+    /** @brief Checks if the line is exactly a literal, e.g. a section's end marker */
+    bool operator==(const char *literal) const
+    {
+        return std::strlen(literal) == size && std::memcmp(data, literal, size) == 0;
+    }
+
+    bool operator!=(const char *literal) const { return !(*this == literal); }
+};
+
+/**
+ * @brief Reads the lines of a text save straight from its bytes, as Table::saveGame() wrote them
+ * @details The zero-copy counterpart of the istream loaders: lines are TextSpans into the
+ *          caller's buffer, numbers and bean names are decoded in place, and nothing is
+ *          allocated. A line ends at '\n', and a '\r' before it is dropped. Running out of
+ *          lines, a malformed number or an unknown bean name throws std::runtime_error.
+ */
+class TextReader
+{
+public:
+    /**
+     * @brief Constructs a reader over a range of characters
+     * @param data First character; the characters must outlive the reader
+     * @param size Number of characters
+     */
+    TextReader(const char *data, std::size_t size) : next(data), end(data + size) {}
+
+    /** @brief Checks if every line has been read */
+    bool atEnd() const { return next == end; }
+
+    /**
+     * @brief Checks if nothing but blank space is left
+     */
+    bool onlyBlankLeft() const;
+
+    /**
+     * @brief Reads the next line
+     * @return The line, without its line ending
+     * @throws std::runtime_error if no line is left
+     */
+    TextSpan line();
+
+    /**
+     * @brief Reads a line that starts with a number, ignoring the rest of it like the istream loaders
+     * @return The number
+     * @throws std::runtime_error if no line is left or it does not start with a non-negative number
+     */
+    int number();
+
+    /**
+     * @brief Reads a line that names a bean
+     * @return The bean id
+     * @throws std::runtime_error if no line is left or it names no bean
+     */
+    BeanId bean() { return bean(line()); }
+
+    /**
+     * @brief Decodes a line that names a bean
+     * @param name The line
+     * @return The bean id
+     * @throws std::runtime_error if it names no bean
+     */
+    static BeanId bean(TextSpan name);
+
+    /**
+     * @brief Reads a line that must be a given end marker
+     * @param marker The marker, e.g. "END_CHAIN"
+     * @throws std::runtime_error if the line is anything else
+     */
+    void expect(const char *marker);
+
+private:
+    const char *next; ///< First character of the next line
+    const char *end;  ///< One past the last character
+};
+
+#endif // TEXT_READER_H
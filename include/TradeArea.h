@@ -1,22 +1,32 @@
 #ifndef TRADE_AREA_H
 #define TRADE_AREA_H
 
-#include <vector>
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 #include <iostream>
 #include "Card.h"
+#include "DiscardPile.h"
+#include "Zobrist.h"
 
 class CardFactory;
+class ByteReader;
+class ByteWriter;
+class TextReader;
 
 /**
  * @brief Represents the trading area where cards can be exchanged
  * @details The TradeArea manages a collection of cards that are available
- *          for trading between players during the game.
+ *          for trading between players during the game. Cards of the same bean
+ *          are interchangeable, so the area is a per-bean histogram: legal(),
+ *          contains() and trade() are single array lookups.
  */
 class TradeArea
 {
 private:
-    std::vector<std::unique_ptr<Card>> cards; ///< Collection of cards in trade area
+    std::array<std::uint8_t, NUM_BEAN_TYPES> counts{}; ///< Cards in trade area per bean type
+    std::uint8_t total = 0;                            ///< Total cards in trade area
+    std::uint64_t hashValue = 0;                       ///< Zobrist hash of the counts
 
 public:
     /** @brief Default constructor */
@@ -26,41 +36,71 @@ public:
      * @brief Constructs a trade area from saved state
      * @param in Input stream containing saved state
      * @param factory Pointer to card factory for card creation
+     * @throws std::runtime_error if a card name is unknown or the input ends before END_TRADE
      */
     TradeArea(std::istream &in, const CardFactory *factory);
 
+    /**
+     * @brief Constructs a trade area from a binary save
+     * @param in Reader positioned at the trade area, as writeBinary() wrote it
+     * @throws std::runtime_error if the data is malformed
+     */
+    explicit TradeArea(ByteReader &in);
+
+    /**
+     * @brief Constructs a trade area by parsing a text save in place, like the stream constructor
+     * @param in Reader positioned at the trade area
+     * @throws std::runtime_error if the data is malformed
+     */
+    explicit TradeArea(TextReader &in);
+
     /** @brief Move constructor */
     TradeArea(TradeArea &&) noexcept = default;
 
     /** @brief Move assignment operator */
     TradeArea &operator=(TradeArea &&) noexcept = default;
 
-    /** @brief Deleted copy constructor (non-copyable) */
-    TradeArea(const TradeArea &) = delete;
+    /** @brief Copy constructor (the histogram is trivially copyable) */
+    TradeArea(const TradeArea &) = default;
 
-    /** @brief Deleted copy assignment (non-copyable) */
-    TradeArea &operator=(const TradeArea &) = delete;
+    /** @brief Copy assignment */
+    TradeArea &operator=(const TradeArea &) = default;
 
     /**
      * @brief Adds a card to the trade area
-     * @param card Unique pointer to the card to add
+     * @param card Pointer to the card to add
      * @return Reference to this trade area
      */
-    TradeArea &operator+=(std::unique_ptr<Card> card);
+    TradeArea &operator+=(const Card *card);
 
     /**
      * @brief Checks if a card can be legally added
      * @param card Pointer to card to check
      * @return true if card can be added, false otherwise
      */
-    bool legal(const Card *card) const;
+    bool legal(const Card *card) const { return card && legal(card->getId()); }
+
+    /**
+     * @brief Checks if a bean can be legally added: the area is empty or already holds that bean
+     * @param bean Bean type to check
+     */
+    bool legal(BeanId bean) const { return total == 0 || counts[static_cast<int>(bean)] != 0; }
 
     /**
      * @brief Attempts to trade a specific bean card
      * @param bean Name of the bean card to trade
-     * @return Unique pointer to the traded card, nullptr if trade failed
+     * @return Pointer to the traded card
+     * @throws std::runtime_error if no matching bean card is found
      */
-    std::unique_ptr<Card> trade(const std::string &bean);
+    const Card *trade(const std::string &bean);
+
+    /**
+     * @brief Takes one card of a bean type out of the trade area
+     * @param bean Bean type to trade
+     * @return Pointer to the traded card
+     * @throws std::runtime_error if no matching bean card is found
+     */
+    const Card *trade(BeanId bean);
 
     /**
      * @brief Checks if a specific bean exists in trade area
@@ -69,15 +109,56 @@ public:
      */
     bool contains(const std::string &beanName) const;
 
+    /** @brief Checks if a bean type is in the trade area */
+    bool contains(BeanId bean) const { return counts[static_cast<int>(bean)] != 0; }
+
+    /** @brief Gets the number of cards of a bean type in the trade area */
+    int count(BeanId bean) const { return counts[static_cast<int>(bean)]; }
+
+    /**
+     * @brief Moves the run of legal cards from the top of a discard pile into the trade area
+     * @param pile Discard pile to take cards from
+     * @return Number of cards moved
+     */
+    std::size_t drain(DiscardPile &pile);
+
+    /**
+     * @brief Moves the run of legal cards from the top of a discard pile into the trade area
+     * @param pile Discard pile to take cards from
+     * @param moved Called with each card once it has been moved, e.g. to journal it
+     * @return Number of cards moved
+     */
+    template <typename Visit>
+    std::size_t drain(DiscardPile &pile, Visit moved)
+    {
+        std::size_t n = 0;
+        while (!pile.empty() && legal(pile.top()))
+        {
+            const Card *card = pile.pickUp();
+            *this += card;
+            moved(card);
+            ++n;
+        }
+        return n;
+    }
+
     /** @brief Checks if trade area is empty */
-    bool empty() const { return cards.empty(); }
+    bool empty() const { return total == 0; }
 
     /** @brief Gets number of cards in trade area */
-    size_t numCards() const { return cards.size(); }
+    size_t numCards() const { return total; }
+
+    /**
+     * @brief Zobrist hash of the cards on offer (the k-th copy of a bean has its own key),
+     *        kept up to date as cards come and go
+     */
+    std::uint64_t hash() const { return hashValue; }
 
-    /** @brief Iterator access for range-based for loops */
-    auto begin() const { return cards.begin(); }
-    auto end() const { return cards.end(); }
+    /**
+     * @brief Checks if the cards on offer differ from an earlier copy, e.g. the last checkpoint
+     * @param base The earlier copy
+     */
+    bool changedSince(const TradeArea &base) const { return hashValue != base.hashValue || counts != base.counts; }
 
     /**
      * @brief Serializes trade area state to stream
@@ -85,6 +166,12 @@ public:
      */
     void serialize(std::ostream &out) const;
 
+    /**
+     * @brief Writes the trade area to a binary save: its size, then its beans grouped by type
+     * @param out Writer to append to
+     */
+    void writeBinary(ByteWriter &out) const;
+
     /**
      * @brief Outputs trade area state to stream
      * @param out Output stream
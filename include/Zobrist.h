@@ -0,0 +1,56 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "Card.h"
+#include "GameRng.h"
+
+/**
+ * @brief Zobrist keys for hashing game positions.
+ * @details Every fact about a position (this bean at this place of a hand, this chain in this
+ *          field, this many coins, ...) has a pseudo-random 64-bit key, and a position's hash is
+ *          the XOR of the keys of its facts. A change to the position XORs out the facts that
+ *          stopped being true and XORs in the new ones, so each part of the game keeps its hash
+ *          up to date in O(1) per card moved. Keys are computed from their coordinates with the
+ *          SplitMix64 mix, so there are no tables to initialize and the hash of a position is
+ *          the same on every run and platform.
+ */
+namespace zobrist {
+
+/**
+ * @brief The kinds of facts a position is made of.
+ */
+enum class Part : std::uint64_t {
+    Hand,      ///< (position in hand, bean); Hand::hash() weights (CAPACITY, bean) by position
+    Chain,     ///< (field * NUM_BEAN_TYPES + bean, chain length)
+    Coins,     ///< (coins)
+    Fields,    ///< (number of usable fields)
+    Deck,      ///< (position from the bottom, bean)
+    Discard,   ///< (position from the bottom, bean)
+    Trade,     ///< (bean, copy number)
+    Turn,      ///< (current player)
+    DeckCount, ///< (bean, cards of it left in the deck), for hashing a deck regardless of order
+    Phase      ///< (decision of the turn)
+};
+
+/**
+ * @brief Key of one fact.
+ * @param part Kind of fact.
+ * @param a First coordinate.
+ * @param b Second coordinate.
+ */
+constexpr std::uint64_t key(Part part, int a, int b = 0) {
+    return GameRng::mix((static_cast<std::uint64_t>(part) << 40 ^ static_cast<std::uint64_t>(a) << 20 ^
+                         static_cast<std::uint64_t>(b)) * GameRng::GOLDEN + GameRng::GOLDEN);
+}
+
+/**
+ * @brief Key of a bean at a position of an ordered pile (hand, deck or discard pile).
+ */
+constexpr std::uint64_t key(Part part, int position, BeanId bean) {
+    return key(part, position, static_cast<int>(bean));
+}
+
+} // namespace zobrist
+
+#endif // ZOBRIST_H
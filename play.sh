@@ -5,8 +5,18 @@ if [ -f "Game" ] || [ -f "Game.exe" ]; then
     rm -f Game Game.exe
 fi
 
-# Compile the C++ code
-g++ -std=c++14 src/*.cpp -Iinclude -o Game
+# Compile the game engine (every source except the terminal front end) into a static library
+mkdir -p build
+rm -f build/*.o build/libbohnanza.a
+for src in src/*.cpp; do
+    if [ "$src" != "src/Main.cpp" ]; then
+        g++ -std=c++14 -c "$src" -Iinclude -o "build/$(basename "${src%.cpp}").o" || exit 1
+    fi
+done
+ar rcs build/libbohnanza.a build/*.o
+
+# Compile the terminal front end and link it against the engine library
+g++ -std=c++14 -pthread src/Main.cpp -Iinclude -Lbuild -lbohnanza -o Game || exit 1
 
 # Run the executable (works on macOS, Linux, and Windows with a Unix-like shell)
-./Game
\ No newline at end of file
+./Game "$@"
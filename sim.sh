@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Compile the game engine (every source except the terminal front end) into an optimized static library
+mkdir -p build/sim
+rm -f build/sim/*.o build/sim/libbohnanza.a
+for src in src/*.cpp; do
+    if [ "$src" != "src/Main.cpp" ]; then
+        g++ -std=c++14 -O2 -c "$src" -Iinclude -o "build/sim/$(basename "${src%.cpp}").o" || exit 1
+    fi
+done
+ar rcs build/sim/libbohnanza.a build/sim/*.o
+
+# Compile the batch self-play simulator and link it against the engine library
+g++ -std=c++14 -O2 -pthread sim/*.cpp -Iinclude -Lbuild/sim -lbohnanza -o bohnanza-sim || exit 1
+
+# Run the simulator, passing along any arguments (e.g. ./sim.sh -n 100000 greedy random)
+./bohnanza-sim "$@"
@@ -0,0 +1,573 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Agent.h"
+#include "CardFactory.h"
+#include "CardTracker.h"
+#include "CheckpointWriter.h"
+#include "GameLog.h"
+#include "MctsAgent.h"
+#include "MoveGen.h"
+#include "Table.h"
+
+/**
+ * @brief Highest score and game length tracked individually in the histograms; larger values are
+ *        counted in the last bucket.
+ */
+constexpr int MAX_TRACKED = 127;
+
+/** @brief Number of games a worker takes from its own queue at a time */
+constexpr long long CHUNK = 64;
+
+/**
+ * @brief Search iterations per decision of the "mcts" agent. Games already run one per thread,
+ *        so the agent searches on one thread with a fixed number of iterations rather than a
+ *        time budget, which keeps runs reproducible.
+ */
+constexpr long long MCTS_ITERATIONS = 500;
+
+/**
+ * @brief Command line settings of a simulation run.
+ */
+struct Options {
+    long long games = 10000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = CardFactory::randomSeed();
+    std::string agents[2] = {"greedy", "random"};
+    bool verify = false;
+};
+
+/**
+ * @brief Results gathered by one worker, merged into the totals at the end.
+ *        Indexed by agent (0 or 1), not by seat.
+ */
+struct Stats {
+    long long games = 0;
+    long long wins[2] = {0, 0};
+    long long ties = 0;
+    std::vector<long long> scores[2] = {std::vector<long long>(MAX_TRACKED + 1),
+                                        std::vector<long long>(MAX_TRACKED + 1)};
+    std::vector<long long> lengths = std::vector<long long>(MAX_TRACKED + 1);
+    long long checks = 0;
+    long long mismatches = 0;
+
+    void merge(const Stats &other) {
+        games += other.games;
+        ties += other.ties;
+        checks += other.checks;
+        mismatches += other.mismatches;
+        for (int a = 0; a < 2; ++a) {
+            wins[a] += other.wins[a];
+            for (int i = 0; i <= MAX_TRACKED; ++i) {
+                scores[a][i] += other.scores[a][i];
+            }
+        }
+        for (int i = 0; i <= MAX_TRACKED; ++i) {
+            lengths[i] += other.lengths[i];
+        }
+    }
+};
+
+/**
+ * @brief A range of game numbers owned by one worker. The owner takes chunks from the front;
+ *        idle workers steal the back half.
+ */
+class WorkQueue {
+public:
+    void assign(long long first, long long last) {
+        std::lock_guard<std::mutex> lock(mutex);
+        begin = first;
+        end = last;
+    }
+
+    bool pop(long long &first, long long &last) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (begin == end) {
+            return false;
+        }
+        first = begin;
+        last = std::min(begin + CHUNK, end);
+        begin = last;
+        return true;
+    }
+
+    bool steal(long long &first, long long &last) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (begin == end) {
+            return false;
+        }
+        first = begin + (end - begin) / 2;
+        last = end;
+        end = first;
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    long long begin = 0;
+    long long end = 0;
+};
+
+/**
+ * @brief Creates an agent by name.
+ * @param name "greedy", "random" or "mcts".
+ * @param rng Generator stream for agents that make random choices.
+ * @return The agent, nullptr if the name is unknown.
+ */
+std::unique_ptr<Agent> makeAgent(const std::string &name, const GameRng &rng) {
+    if (name == "greedy") {
+        return std::make_unique<GreedyAgent>();
+    }
+    if (name == "random") {
+        return std::make_unique<RandomAgent>(rng);
+    }
+    if (name == "mcts") {
+        MctsSettings settings;
+        settings.budget = std::chrono::milliseconds(0);
+        settings.iterations = MCTS_ITERATIONS;
+        return std::make_unique<MctsAgent>(rng, settings);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Records the result of a finished game.
+ * @param state The final position.
+ * @param firstSeat Agent (0 or 1) that played as player 1.
+ * @param turns Number of turns played.
+ * @param stats Results of the calling worker.
+ */
+void tally(const GameState &state, int firstSeat, int turns, Stats &stats) {
+    int score[2];
+    score[firstSeat] = state.players[0].getNumCoins();
+    score[1 - firstSeat] = state.players[1].getNumCoins();
+
+    ++stats.games;
+    if (score[0] == score[1]) {
+        ++stats.ties;
+    } else {
+        ++stats.wins[score[0] > score[1] ? 0 : 1];
+    }
+    for (int a = 0; a < 2; ++a) {
+        ++stats.scores[a][std::min(score[a], MAX_TRACKED)];
+    }
+    ++stats.lengths[std::min(turns, MAX_TRACKED)];
+}
+
+/**
+ * @brief Plays one complete game and records it.
+ *        The game number selects the RNG stream, so a game's result does not depend on which
+ *        thread plays it. The agents swap seats on odd games to cancel the first player advantage.
+ * @param options Settings of the run.
+ * @param game Game number.
+ * @param stats Results of the calling worker.
+ */
+void playGame(const Options &options, long long game, Stats &stats) {
+    GameRng rng(options.seed, static_cast<std::uint64_t>(game));
+    GameState state;
+    GameEngine engine(state);
+    engine.deal(*CardFactory::getFactory()->getDeck(rng));
+
+    std::unique_ptr<Agent> agents[2] = {makeAgent(options.agents[0], rng.split()),
+                                        makeAgent(options.agents[1], rng.split())};
+    int firstSeat = static_cast<int>(game & 1);
+    Agent *seats[2] = {agents[firstSeat].get(), agents[1 - firstSeat].get()};
+
+    int turns = 0;
+    while (!engine.isOver()) {
+        engine.playTurn(*seats[state.currentPlayer - 1]);
+        ++turns;
+    }
+    tally(state, firstSeat, turns, stats);
+}
+
+/** @brief Serializes the mismatch reports of workers that find one at the same time */
+std::mutex reportMutex;
+
+/**
+ * @brief What a rebuilt position is compared with: the hash and text save of the live one.
+ */
+struct Snapshot {
+    std::uint64_t hash;
+    std::string text;
+};
+
+/**
+ * @brief Takes the snapshot of a table.
+ */
+Snapshot snapshot(const Table &table) {
+    std::ostringstream text;
+    table.saveGame(text);
+    return Snapshot{table.hash(), text.str()};
+}
+
+/**
+ * @brief Counts a check and, if it found a problem, reports it on stderr.
+ * @param problem What went wrong, empty if nothing did.
+ */
+void record(long long game, int turn, const char *what, const std::string &problem, Stats &stats) {
+    ++stats.checks;
+    if (!problem.empty()) {
+        ++stats.mismatches;
+        std::lock_guard<std::mutex> lock(reportMutex);
+        std::cerr << "Game " << game << ", turn " << turn << ", " << what << ": " << problem << "\n";
+    }
+}
+
+/**
+ * @brief Rebuilds a position and compares it with the live one.
+ *        A table loaded from a save hashes its position from scratch, so an equal hash also
+ *        confirms the live table's incrementally kept hash.
+ * @param restore Returns the rebuilt table; an exception it throws counts as a mismatch.
+ */
+template <typename Restore>
+void check(long long game, int turn, const char *what, const Snapshot &expected, Restore restore, Stats &stats) {
+    std::string problem;
+    try {
+        const Table &restored = restore();
+        Snapshot actual = snapshot(restored);
+        if (actual.hash != expected.hash) {
+            problem = "hash differs";
+        } else if (actual.text != expected.text) {
+            problem = "text save differs";
+        }
+    } catch (const std::exception &e) {
+        problem = e.what();
+    }
+    record(game, turn, what, problem, stats);
+}
+
+/**
+ * @brief Compares a tracker that followed the game change by change with one recounted from
+ *        the table. The recount knows nothing of the opponent's hand, so the cards the follower
+ *        knows at the front of it are unseen again.
+ * @return The difference, empty if there is none.
+ */
+std::string compareTracker(const CardTracker &followed, const GameState &state) {
+    CardTracker recounted(followed.getObserver());
+    recounted.reset(state);
+
+    const Hand &opponentHand = state.getPlayer(3 - followed.getObserver()).getHand();
+    if (followed.knownInOpponentHand() > static_cast<int>(opponentHand.size())) {
+        return "knows more cards than the opponent holds";
+    }
+    std::array<int, NUM_BEAN_TYPES> known{};
+    for (int i = 0; i < followed.knownInOpponentHand(); ++i) {
+        ++known[static_cast<int>(opponentHand.beanAt(i))];
+    }
+
+    if (followed.deckSize() != recounted.deckSize()) {
+        return "deck size differs";
+    }
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b) {
+        BeanId bean = static_cast<BeanId>(b);
+        if (followed.unseen(bean) + known[b] != recounted.unseen(bean)) {
+            return "unseen " + Card::get(bean)->getName() + " cards differ";
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief Walks the decisions of the next turn and tries every action MoveGen lists for each
+ *        on a copy of the position, where GameEngine::step() must accept it. The walk goes on
+ *        with the last action listed, so it takes trade area cards and discards when it can.
+ * @param state The position before the turn's draw; it is left unchanged.
+ * @return The first action refused, empty if none was.
+ */
+std::string checkMoves(const GameState &state) {
+    GameState walk = state;
+    GameEngine engine(walk);
+    engine.drawCard();
+
+    TurnPhase phase = TurnPhase::BuyField;
+    bool turnOver = false;
+    while (!turnOver) {
+        turnOver = phase == TurnPhase::Discard;
+        MoveList moves;
+        MoveGen::generate(walk, phase, moves);
+        for (int action : moves) {
+            GameState tried = walk;
+            TurnPhase next = phase;
+            try {
+                GameEngine(tried).step(next, action);
+            } catch (const std::exception &e) {
+                return "action " + std::to_string(action) + " of decision " + std::to_string(static_cast<int>(phase)) +
+                       " refused: " + e.what();
+            }
+        }
+        engine.step(phase, moves[moves.size() - 1]);
+    }
+    return "";
+}
+
+/**
+ * @brief Plays the same game as playGame() on a Table and checks every way a position is
+ *        saved, rebuilt or followed against the live one: before each turn, the actions
+ *        MoveGen lists; after each turn, both players' card trackers, the text and binary
+ *        saves reloaded and the latest checkpoint restored; after the game, the GameLog
+ *        replayed to each turn and the journal undone back to each turn and the deal.
+ * @param options Settings of the run.
+ * @param game Game number.
+ * @param stats Results of the calling worker.
+ */
+void verifyGame(const Options &options, long long game, Stats &stats) {
+    GameRng rng(options.seed, static_cast<std::uint64_t>(game));
+    Table table("Player1", "Player2");
+    GameEngine engine(table);
+    CardTracker trackers[2] = {CardTracker(1), CardTracker(2)};
+    engine.track(trackers[0]);
+    engine.track(trackers[1]);
+    engine.deal(*CardFactory::getFactory()->getDeck(rng));
+
+    std::unique_ptr<Agent> agents[2] = {makeAgent(options.agents[0], rng.split()),
+                                        makeAgent(options.agents[1], rng.split())};
+    int firstSeat = static_cast<int>(game & 1);
+    Agent *seats[2] = {agents[firstSeat].get(), agents[1 - firstSeat].get()};
+
+    std::ostringstream logged(std::ios::out | std::ios::binary);
+    GameLog log(logged, table);
+    engine.record(log);
+    CheckpointWriter checkpoints;
+    std::vector<std::uint8_t> base, delta;
+
+    // The position and the number of journal moves after each turn, from the deal on
+    std::vector<Snapshot> positions{snapshot(table)};
+    std::vector<std::size_t> moves{table.getJournal().moves()};
+
+    while (!engine.isOver()) {
+        int turn = static_cast<int>(positions.size());
+        record(game, turn, "move list", checkMoves(table.getState()), stats);
+
+        engine.playTurn(*seats[table.getCurrentPlayer() - 1]);
+        Snapshot now = snapshot(table);
+        for (const CardTracker &tracker : trackers) {
+            record(game, turn, "card tracker", compareTracker(tracker, table.getState()), stats);
+        }
+
+        check(game, turn, "text save", now, [&] {
+            return Table(reinterpret_cast<const std::uint8_t *>(now.text.data()), now.text.size());
+        }, stats);
+
+        std::vector<std::uint8_t> binary;
+        table.saveBinary(binary);
+        check(game, turn, "binary save", now, [&] { return Table(binary.data(), binary.size()); }, stats);
+
+        delta.clear();
+        if (checkpoints.checkpoint(table, delta)) {
+            base.swap(delta);
+            delta.clear();
+        }
+        check(game, turn, "checkpoint", now, [&] {
+            return CheckpointWriter::restore(base.data(), base.size(), delta.empty() ? nullptr : delta.data(),
+                                             delta.size());
+        }, stats);
+
+        positions.push_back(std::move(now));
+        moves.push_back(table.getJournal().moves());
+    }
+
+    std::string bytes = logged.str();
+    for (int turn = 0; turn < static_cast<int>(positions.size()); ++turn) {
+        check(game, turn, "log replay", positions[turn], [&] {
+            return GameReplay(reinterpret_cast<const std::uint8_t *>(bytes.data()), bytes.size()).at(turn);
+        }, stats);
+    }
+
+    tally(table.getState(), firstSeat, static_cast<int>(positions.size()) - 1, stats);
+
+    for (int turn = static_cast<int>(positions.size()) - 1; turn >= 0; --turn) {
+        check(game, turn, "undo", positions[turn], [&]() -> const Table & {
+            table.undo(static_cast<int>(table.getJournal().moves() - moves[turn]));
+            return table;
+        }, stats);
+    }
+}
+
+/**
+ * @brief Runs one worker: plays its own games, then steals from the others until none are left.
+ * @param options Settings of the run.
+ * @param queues Work queues of every worker.
+ * @param self Index of this worker's queue.
+ * @param stats Results of this worker.
+ */
+void runWorker(const Options &options, std::vector<WorkQueue> &queues, unsigned self, Stats &stats) {
+    long long first, last;
+    for (;;) {
+        while (queues[self].pop(first, last)) {
+            for (long long game = first; game < last; ++game) {
+                if (options.verify) {
+                    verifyGame(options, game, stats);
+                } else {
+                    playGame(options, game, stats);
+                }
+            }
+        }
+
+        bool stolen = false;
+        for (unsigned i = 1; i < queues.size() && !stolen; ++i) {
+            stolen = queues[(self + i) % queues.size()].steal(first, last);
+        }
+        if (!stolen) {
+            return;
+        }
+        queues[self].assign(first, last);
+    }
+}
+
+/**
+ * @brief Finds the value below which a fraction of a histogram's samples lie.
+ * @param histogram Counts per value.
+ * @param total Number of samples.
+ * @param fraction Fraction between 0 and 1.
+ */
+int percentile(const std::vector<long long> &histogram, long long total, double fraction) {
+    long long target = static_cast<long long>(fraction * (total - 1));
+    long long seen = 0;
+    for (int i = 0; i < static_cast<int>(histogram.size()); ++i) {
+        seen += histogram[i];
+        if (seen > target) {
+            return i;
+        }
+    }
+    return static_cast<int>(histogram.size()) - 1;
+}
+
+/**
+ * @brief Computes the mean of a histogram.
+ */
+double mean(const std::vector<long long> &histogram, long long total) {
+    double sum = 0;
+    for (int i = 0; i < static_cast<int>(histogram.size()); ++i) {
+        sum += static_cast<double>(i) * histogram[i];
+    }
+    return total > 0 ? sum / total : 0;
+}
+
+/**
+ * @brief Prints the aggregate results of a run.
+ */
+void report(const Options &options, const Stats &stats, double seconds) {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games: " << stats.games << "  Threads: " << options.threads << "  Seed: " << options.seed << "\n";
+    std::cout << "Elapsed: " << seconds << " s  (" << std::setprecision(0) << stats.games / seconds
+              << " games/sec)\n\n" << std::setprecision(1);
+
+    for (int a = 0; a < 2; ++a) {
+        std::cout << "Agent " << a + 1 << " (" << options.agents[a] << "): wins " << stats.wins[a] << " ("
+                  << 100.0 * stats.wins[a] / stats.games << "%), score mean " << mean(stats.scores[a], stats.games)
+                  << ", p10/p50/p90 " << percentile(stats.scores[a], stats.games, 0.1) << "/"
+                  << percentile(stats.scores[a], stats.games, 0.5) << "/"
+                  << percentile(stats.scores[a], stats.games, 0.9) << "\n";
+    }
+    std::cout << "Ties: " << stats.ties << " (" << 100.0 * stats.ties / stats.games << "%)\n\n";
+
+    std::cout << "Score distribution (coins: " << options.agents[0] << " / " << options.agents[1] << " games)\n";
+    for (int low = 0; low <= MAX_TRACKED; low += 4) {
+        long long counts[2] = {0, 0};
+        for (int i = low; i < low + 4 && i <= MAX_TRACKED; ++i) {
+            counts[0] += stats.scores[0][i];
+            counts[1] += stats.scores[1][i];
+        }
+        if (counts[0] || counts[1]) {
+            std::cout << "  " << std::setw(3) << low << "-" << std::setw(3) << std::left << low + 3 << std::right
+                      << std::setw(12) << counts[0] << std::setw(12) << counts[1] << "\n";
+        }
+    }
+
+    auto first = std::find_if(stats.lengths.begin(), stats.lengths.end(), [](long long n) { return n > 0; });
+    auto last = std::find_if(stats.lengths.rbegin(), stats.lengths.rend(), [](long long n) { return n > 0; });
+    std::cout << "\nGame length (turns): mean " << mean(stats.lengths, stats.games) << ", min "
+              << first - stats.lengths.begin() << ", max " << stats.lengths.rend() - last - 1 << "\n";
+    if (options.verify) {
+        std::cout << "Round trips: " << stats.checks << " checked, " << stats.mismatches << " mismatched\n";
+    }
+}
+
+/**
+ * @brief Prints the command line syntax.
+ */
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [-n games] [-t threads] [-s seed] [--verify] [agent1 [agent2]]\n"
+              << "Agents: greedy, random, mcts (default: greedy random)\n"
+              << "--verify: check saves, checkpoints, the game log, undo, card trackers and move lists every turn\n";
+}
+
+/**
+ * @brief Batch self-play simulator: plays many complete games between two agents on every core
+ *        and reports win rates, score distributions, game lengths and throughput. With --verify
+ *        it also checks the save formats, checkpoints, game log, undo, card trackers and move
+ *        lists on every turn, and fails if any of them disagrees with the game.
+ * @return Exit status code.
+ */
+int main(int argc, char *argv[]) {
+    Options options;
+    int agentArg = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-n" || arg == "-t" || arg == "-s") && i + 1 < argc) {
+            unsigned long long value = std::strtoull(argv[++i], nullptr, 10);
+            if (arg == "-n") {
+                options.games = static_cast<long long>(value);
+            } else if (arg == "-t") {
+                options.threads = static_cast<unsigned>(value);
+            } else {
+                options.seed = value;
+            }
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg[0] != '-' && agentArg < 2) {
+            options.agents[agentArg++] = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    for (const std::string &name : options.agents) {
+        if (!makeAgent(name, GameRng(0))) {
+            std::cerr << "Error: Unknown agent: " << name << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.games <= 0 || options.threads == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Split the games evenly; workers that finish early steal from the others
+    std::vector<WorkQueue> queues(options.threads);
+    for (unsigned t = 0; t < options.threads; ++t) {
+        queues[t].assign(options.games * t / options.threads, options.games * (t + 1) / options.threads);
+    }
+
+    std::vector<Stats> results(options.threads);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.emplace_back(runWorker, std::cref(options), std::ref(queues), t, std::ref(results[t]));
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Stats total;
+    for (const Stats &stats : results) {
+        total.merge(stats);
+    }
+    report(options, total, elapsed.count());
+    return total.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,362 @@
+#include "Agent.h"
+#include <cctype>
+#include <limits>
+#include "CardFactory.h"
+#include "MoveGen.h"
+
+/**
+ * @brief Asks a yes/no question until the answer is 'y' or 'n'
+ *
+ * @param prompt The question to ask
+ * @return true if the answer is 'y', false if it is 'n'
+ */
+bool TerminalAgent::ask(const std::string &prompt)
+{
+    std::string input;
+    while (true)
+    {
+        out << prompt << " (y/n): ";
+
+        if (!std::getline(in, input))
+        {
+            in.clear();
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
+
+        input.erase(0, input.find_first_not_of(" \t\n\r\f\v"));
+        input.erase(input.find_last_not_of(" \t\n\r\f\v") + 1);
+
+        if (input.length() == 1)
+        {
+            char choice = std::tolower(input[0]);
+            if (choice == 'y')
+                return true;
+            if (choice == 'n')
+                return false;
+        }
+
+        out << "Invalid input. Please enter 'y' or 'n'.\n";
+    }
+}
+
+/**
+ * @brief Reads an integer answer and discards the rest of the line
+ *
+ * @return The number read
+ */
+int TerminalAgent::readIndex()
+{
+    int index;
+    in >> index;
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return index;
+}
+
+bool TerminalAgent::pauseToSave(const GameEngine &, std::string &filename)
+{
+    if (!ask("Would you like to pause and save the game?"))
+    {
+        return false;
+    }
+    out << "Enter filename to save: ";
+    std::getline(in, filename);
+    return true;
+}
+
+bool TerminalAgent::continueAfterSave(const GameEngine &)
+{
+    return ask("Would you like to continue playing?");
+}
+
+bool TerminalAgent::buyThirdChain(const GameEngine &)
+{
+    return ask("Would you like to buy a third chain for 3 coins?");
+}
+
+/**
+ * @brief Asks for a bean name until a known bean is entered or the player stops
+ *
+ * @param engine The game in progress
+ * @param bean Set to the bean type entered
+ * @return false if the player declines or enters 'skip'
+ */
+bool TerminalAgent::chooseTradeBean(const GameEngine &engine, BeanId &bean)
+{
+    while (ask("Would you like to add a card from the trade area to your chains?"))
+    {
+        out << "Available beans in trade area: " << engine.getState().tradeArea << "\n";
+        out << "Enter bean name to chain (or 'skip' to move on): ";
+        std::string beanName;
+        std::getline(in, beanName);
+        if (beanName == "skip")
+        {
+            return false;
+        }
+        if (CardFactory::decodeBean(beanName, bean))
+        {
+            return true;
+        }
+        out << "Error: No matching bean card found in trade area\n";
+    }
+    return false;
+}
+
+bool TerminalAgent::playSecondCard(const GameEngine &)
+{
+    return ask("\nWould you like to play another card?");
+}
+
+/**
+ * @brief Lists the planted chains with their value and asks which one to harvest
+ *
+ * @param engine The game in progress
+ * @return Index of the chosen chain, -1 if cancelled or not a planted chain
+ */
+int TerminalAgent::chooseChainToHarvest(const GameEngine &engine)
+{
+    if (!ask("\nWould you like to harvest any chains?"))
+    {
+        return -1;
+    }
+
+    const Player &player = engine.currentPlayer();
+    out << "Available chains to harvest:\n";
+    for (int i = 0; i < player.getMaxNumChains(); i++)
+    {
+        const Chain_Base &chain = player[i];
+        if (chain.size() > 0)
+        {
+            out << i + 1 << ". ";
+            chain.print(out);
+            out << " (Value: " << chain.sell() << " coins)\n";
+        }
+    }
+
+    out << "Enter chain number to harvest (1-" << player.getMaxNumChains() << ") or 0 to cancel: ";
+    int chainNum = readIndex();
+    if (chainNum > 0 && chainNum <= player.getMaxNumChains() && player[chainNum - 1].size() > 0)
+    {
+        return chainNum - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Shows the whole hand and asks which card to discard
+ *
+ * @param engine The game in progress
+ * @return The index entered, -1 if the player declines
+ */
+int TerminalAgent::chooseCardToDiscard(const GameEngine &engine)
+{
+    if (!ask("\nWould you like to discard a card?"))
+    {
+        return -1;
+    }
+    engine.currentPlayer().printHand(out, true);
+    out << "Enter index of card to discard: ";
+    return readIndex();
+}
+
+bool RandomAgent::buyThirdChain(const GameEngine &)
+{
+    return rng.below(2) == 1;
+}
+
+/**
+ * @brief Takes a random chainable trade area card half of the time
+ *
+ * @param engine The game in progress
+ * @param bean Set to the chosen bean type
+ * @return false if the agent stops or no card in the trade area can be chained
+ */
+bool RandomAgent::chooseTradeBean(const GameEngine &engine, BeanId &bean)
+{
+    BeanMask takeable = MoveGen::tradeMoves(engine.getState());
+
+    BeanId candidates[NUM_BEAN_TYPES];
+    int numCandidates = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId id = static_cast<BeanId>(b);
+        if (takeable & beanBit(id))
+        {
+            candidates[numCandidates++] = id;
+        }
+    }
+
+    if (numCandidates == 0 || rng.below(2) == 0)
+    {
+        return false;
+    }
+    bean = candidates[rng.below(numCandidates)];
+    return true;
+}
+
+bool RandomAgent::playSecondCard(const GameEngine &)
+{
+    return rng.below(2) == 1;
+}
+
+/**
+ * @brief Picks a random planted chain, or no harvest, with equal chance
+ *
+ * @param engine The game in progress
+ * @return Index of the chain, -1 for no harvest
+ */
+int RandomAgent::chooseChainToHarvest(const GameEngine &engine)
+{
+    const Player &player = engine.currentPlayer();
+    int planted[3];
+    int numPlanted = 0;
+    for (int i = 0; i < player.getMaxNumChains(); ++i)
+    {
+        if (!player[i].empty())
+        {
+            planted[numPlanted++] = i;
+        }
+    }
+
+    int choice = static_cast<int>(rng.below(numPlanted + 1));
+    return choice == numPlanted ? -1 : planted[choice];
+}
+
+/**
+ * @brief Picks a random card of the hand, or no discard, with equal chance
+ *
+ * @param engine The game in progress
+ * @return Index of the card, -1 for no discard
+ */
+int RandomAgent::chooseCardToDiscard(const GameEngine &engine)
+{
+    int handSize = static_cast<int>(engine.currentPlayer().getHand().size());
+    return static_cast<int>(rng.below(handSize + 1)) - 1;
+}
+
+bool GreedyAgent::buyThirdChain(const GameEngine &)
+{
+    return true;
+}
+
+/**
+ * @brief Takes trade area cards that extend a planted chain
+ *
+ * @param engine The game in progress
+ * @param bean Set to the bean type to take
+ * @return false once no trade area card matches a planted chain
+ */
+bool GreedyAgent::chooseTradeBean(const GameEngine &engine, BeanId &bean)
+{
+    const TradeArea &tradeArea = engine.getState().tradeArea;
+    const Player &player = engine.currentPlayer();
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId id = static_cast<BeanId>(b);
+        if (tradeArea.contains(id) && player.findChain(id))
+        {
+            bean = id;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Plants a second card only if it extends a planted chain
+ *
+ * @param engine The game in progress
+ * @return true if the front card of the hand matches a planted chain
+ */
+bool GreedyAgent::playSecondCard(const GameEngine &engine)
+{
+    const Player &player = engine.currentPlayer();
+    return !player.isHandEmpty() && player.findChain(player.getHand().beanAt(0));
+}
+
+/**
+ * @brief Harvests a chain that cannot earn more, or the most valuable chain when
+ *        the next card of the hand has no field to go to
+ *
+ * @param engine The game in progress
+ * @return Index of the chain, -1 for no harvest
+ */
+int GreedyAgent::chooseChainToHarvest(const GameEngine &engine)
+{
+    const Player &player = engine.currentPlayer();
+    for (int i = 0; i < player.getMaxNumChains(); ++i)
+    {
+        const Chain_Base &chain = player[i];
+        if (!chain.empty() && Beanometer::cardsToNextCoin(chain.getBeanId(), chain.size()) == 0)
+        {
+            return i;
+        }
+    }
+
+    if (player.isHandEmpty() || player.canChain(player.getHand().beanAt(0)))
+    {
+        return -1;
+    }
+
+    int best = -1;
+    for (int i = 0; i < player.getMaxNumChains(); ++i)
+    {
+        if (best < 0 || player[i].sell() > player[best].sell() ||
+            (player[i].sell() == player[best].sell() && player[i].size() > player[best].size()))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Discards the last card behind the front that matches no planted chain
+ *
+ * @param engine The game in progress
+ * @return Index of the card, -1 if every card is wanted
+ */
+int GreedyAgent::chooseCardToDiscard(const GameEngine &engine)
+{
+    const Player &player = engine.currentPlayer();
+    const Hand &hand = player.getHand();
+    for (int i = static_cast<int>(hand.size()) - 1; i >= 1; --i)
+    {
+        if (!player.findChain(hand.beanAt(i)))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ScriptedAgent::buyThirdChain(const GameEngine &)
+{
+    return take(0) != 0;
+}
+
+bool ScriptedAgent::chooseTradeBean(const GameEngine &, BeanId &bean)
+{
+    int choice = take(-1);
+    if (choice < 0 || choice >= NUM_BEAN_TYPES)
+    {
+        return false;
+    }
+    bean = static_cast<BeanId>(choice);
+    return true;
+}
+
+bool ScriptedAgent::playSecondCard(const GameEngine &)
+{
+    return take(0) != 0;
+}
+
+int ScriptedAgent::chooseChainToHarvest(const GameEngine &)
+{
+    return take(-1);
+}
+
+int ScriptedAgent::chooseCardToDiscard(const GameEngine &)
+{
+    return take(-1);
+}
@@ -0,0 +1,87 @@
+#include "BinaryIO.h"
+#include <algorithm>
+
+/**
+ * @brief Writes bean ids two to a byte
+ *
+ * @param beans The bean ids
+ * @param count Number of bean ids
+ *
+ * The first of each pair goes in the high nibble; an odd count is padded with a zero nibble.
+ */
+void ByteWriter::beans(const BeanId *beans, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i += 2)
+    {
+        int high = static_cast<int>(beans[i]);
+        int low = i + 1 < count ? static_cast<int>(beans[i + 1]) : 0;
+        buffer.push_back(static_cast<std::uint8_t>(high << 4 | low));
+    }
+}
+
+/**
+ * @brief Writes a pile of bean ids as a change to an earlier copy
+ *
+ * @param beans The pile, bottom first
+ * @param count Number of bean ids in the pile
+ * @param base The earlier copy, bottom first
+ * @param baseCount Number of bean ids in the earlier copy
+ *
+ * A pile that was only taken from, like the deck, costs two bytes; one that was only
+ * added to, like the discard pile, costs two bytes and its new ids.
+ */
+void ByteWriter::beanDelta(const BeanId *beans, std::size_t count, const BeanId *base, std::size_t baseCount)
+{
+    std::size_t shared = std::mismatch(beans, beans + std::min(count, baseCount), base).first - beans;
+    byte(static_cast<int>(shared));
+    byte(static_cast<int>(count - shared));
+    this->beans(beans + shared, count - shared);
+}
+
+/**
+ * @brief Reads bean ids packed two to a byte
+ *
+ * @param beans Filled with the bean ids
+ * @param count Number of bean ids
+ * @throws std::runtime_error if the bytes run out, a nibble is not a bean or the padding is not zero
+ */
+void ByteReader::beans(BeanId *beans, std::size_t count)
+{
+    const std::uint8_t *packed = bytes((count + 1) / 2);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int nibble = i % 2 == 0 ? packed[i / 2] >> 4 : packed[i / 2] & 0xF;
+        if (nibble >= NUM_BEAN_TYPES)
+        {
+            throw std::runtime_error("Unknown bean id in binary save: " + std::to_string(nibble));
+        }
+        beans[i] = static_cast<BeanId>(nibble);
+    }
+    if (count % 2 != 0 && (packed[count / 2] & 0xF) != 0)
+    {
+        throw std::runtime_error("Binary save has a bad padding nibble");
+    }
+}
+
+/**
+ * @brief Reads a pile of bean ids as ByteWriter::beanDelta() wrote it against a base
+ *
+ * @param beans Filled with the pile, bottom first
+ * @param capacity Most bean ids beans can hold
+ * @param base The copy the change was written against, bottom first
+ * @param baseCount Number of bean ids in it
+ * @return Number of bean ids in the pile
+ * @throws std::runtime_error if the data is malformed or does not fit the base or the capacity
+ */
+std::size_t ByteReader::beanDelta(BeanId *beans, std::size_t capacity, const BeanId *base, std::size_t baseCount)
+{
+    std::size_t shared = static_cast<std::size_t>(byte());
+    std::size_t added = static_cast<std::size_t>(byte());
+    if (shared > baseCount || shared + added > capacity)
+    {
+        throw std::runtime_error("Binary change does not fit its base");
+    }
+    std::copy(base, base + shared, beans);
+    this->beans(beans + shared, added);
+    return shared + added;
+}
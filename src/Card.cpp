@@ -1,4 +1,9 @@
 #include "Card.h"
+#include "Beanometer.h"
+#include "BeanRegistry.h"
+
+// Flyweight lookup table, in BeanId order
+const std::array<const Card *, NUM_BEAN_TYPES> Card::instances = BeanRegistry::flyweights();
 
 /**
  * @brief Overload of the stream insertion operator for Card objects.
@@ -13,106 +18,20 @@ std::ostream &operator<<(std::ostream &out, const Card &card)
     return out;
 }
 
-// The following implementations define how many cards are needed per coin for each bean type.
-
-// Blue Bean implementation
-int Blue::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 4;
-    case 2: return 6;
-    case 3: return 8;
-    case 4: return 10;
-    default: return 0;
-    }
-}
-
-// Chili Bean implementation
-int Chili::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 3;
-    case 2: return 6;
-    case 3: return 8;
-    case 4: return 9;
-    default: return 0;
-    }
-}
-
-// Stink Bean implementation
-int Stink::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 3;
-    case 2: return 5;
-    case 3: return 7;
-    case 4: return 8;
-    default: return 0;
-    }
-}
+// The beanometer table itself; the declaration in Beanometer.h holds the initializer
+constexpr beanometer_detail::Table Beanometer::table;
 
-// Green Bean implementation
-int Green::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 3;
-    case 2: return 5;
-    case 3: return 6;
-    case 4: return 7;
-    default: return 0;
-    }
-}
+static_assert(Beanometer::coins(BeanId::Blue, 10) == 4 && Beanometer::cardsToNextCoin(BeanId::Blue, 9) == 1,
+              "Beanometer table out of sync with the Blue card");
+static_assert(Beanometer::coins(BeanId::Garden, 1) == 0 && Beanometer::coins(BeanId::Garden, 20) == 3,
+              "Garden beans pay at most 3 coins");
 
-// Soy Bean implementation
-int Soy::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 2;
-    case 2: return 4;
-    case 3: return 6;
-    case 4: return 7;
-    default: return 0;
-    }
-}
-
-// Black Bean implementation
-int Black::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 2;
-    case 2: return 4;
-    case 3: return 5;
-    case 4: return 6;
-    default: return 0;
-    }
-}
-
-// Red Bean implementation
-int Red::getCardsPerCoin(int coins) const
-{
-    switch (coins)
-    {
-    case 1: return 2;
-    case 2: return 3;
-    case 3: return 4;
-    case 4: return 5;
-    default: return 0;
-    }
-}
-
-// Garden Bean implementation
-int Garden::getCardsPerCoin(int coins) const
+/**
+ * @brief Number of cards of this bean needed to earn the given number of coins.
+ * @param coins The number of coins desired.
+ * @return The required number of cards, or 0 if not applicable.
+ */
+int Card::getCardsPerCoin(int coins) const
 {
-    switch (coins)
-    {
-    case 2: return 2;
-    case 3: return 3;
-    default: return 0;
-    }
+    return Beanometer::cardsPerCoin(id, coins);
 }
@@ -3,8 +3,25 @@
 #include <random>
 #include <chrono>
 #include <stdexcept>
+#include <cstring>
 
-std::shared_ptr<CardFactory> CardFactory::instance = nullptr;
+// The composition table itself; the declaration in CardFactory.h holds the initializer
+constexpr std::uint8_t CardFactory::COMPOSITION[NUM_BEAN_TYPES];
+
+namespace
+{
+constexpr int fullDeckSize()
+{
+    int total = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        total += CardFactory::cardsOf(static_cast<BeanId>(b));
+    }
+    return total;
+}
+} // namespace
+
+static_assert(fullDeckSize() == NUM_CARDS, "Bean composition must add up to NUM_CARDS");
 
 /**
  * @brief CardFactory constructor initializes the card pools.
@@ -16,101 +33,144 @@ CardFactory::CardFactory()
 
 /**
  * @brief Retrieve the singleton CardFactory instance.
- * @return Shared pointer to the CardFactory.
+ *        The function-local static is initialized exactly once, thread-safely, on first use;
+ *        afterwards every call is a plain read of immutable data.
+ * @return Pointer to the CardFactory.
  */
-std::shared_ptr<CardFactory> CardFactory::getFactory()
+const CardFactory *CardFactory::getFactory()
 {
-    if (!instance)
-    {
-        instance = std::shared_ptr<CardFactory>(new CardFactory());
-    }
-    return instance;
+    static const CardFactory instance;
+    return &instance;
 }
 
 /**
- * @brief Initialize all card pools with their respective counts.
- *        Creates a map of card types to multiple instances.
+ * @brief Initialize the card pool with the count of each bean type.
+ *        The pool holds bean ids only; the cards themselves are shared flyweights.
  */
 void CardFactory::initializeCards()
 {
-    auto createCards = [this](const std::string &type, int count, auto creator)
+    auto createCards = [this](BeanId type, int count)
     {
-        cards[type].reserve(count);
-        for (int i = 0; i < count; ++i)
-        {
-            cards[type].push_back(std::unique_ptr<Card>(creator()));
-        }
+        cards.insert(cards.end(), count, type);
     };
 
+    cards.reserve(NUM_CARDS); // Total number of cards
+
     // Initialize each bean type with the required counts
-    createCards("Blue", 20, BeanCreator<Blue>::create);
-    createCards("Chili", 18, BeanCreator<Chili>::create);
-    createCards("Stink", 16, BeanCreator<Stink>::create);
-    createCards("Green", 14, BeanCreator<Green>::create);
-    createCards("Soy", 12, BeanCreator<Soy>::create);
-    createCards("Black", 10, BeanCreator<Black>::create);
-    createCards("Red", 8, BeanCreator<Red>::create);
-    createCards("Garden", 6, BeanCreator<Garden>::create);
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        createCards(static_cast<BeanId>(b), cardsOf(static_cast<BeanId>(b)));
+    }
+}
+
+/**
+ * @brief Create a new Deck containing all the cards, shuffled from a random seed.
+ * @return A unique_ptr to the created, shuffled Deck.
+ */
+std::unique_ptr<Deck> CardFactory::getDeck() const
+{
+    return getDeck(randomSeed());
+}
+
+/**
+ * @brief Create a new Deck containing all the cards, shuffled from a game seed.
+ * @param seed 64-bit game seed; it fully determines the order of the deck.
+ * @return A unique_ptr to the created, shuffled Deck.
+ */
+std::unique_ptr<Deck> CardFactory::getDeck(std::uint64_t seed) const
+{
+    GameRng rng(seed);
+    return getDeck(rng);
 }
 
 /**
- * @brief Create a new Deck containing all the cards, then shuffle it.
+ * @brief Create a new Deck containing all the cards, shuffled by the given generator.
+ * @param rng Generator to shuffle with; advanced by the shuffle.
  * @return A unique_ptr to the created, shuffled Deck.
  */
-std::unique_ptr<Deck> CardFactory::getDeck()
+std::unique_ptr<Deck> CardFactory::getDeck(GameRng &rng) const
+{
+    auto deck = std::make_unique<Deck>(cards.data(), cards.size());
+    deck->shuffle(rng);
+    return deck;
+}
+
+/**
+ * @brief Draw a non-deterministic game seed.
+ *        Combines std::random_device with the clock so that workers starting in the
+ *        same tick still get different seeds.
+ * @return A 64-bit seed.
+ */
+std::uint64_t CardFactory::randomSeed()
+{
+    std::random_device device;
+    std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    seed ^= static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return GameRng(seed)();
+}
+
+/**
+ * @brief Decode a bean name into its BeanId.
+ *
+ * Every bean name is identified by its length and first character, so one switch
+ * picks the only candidate and a memcmp confirms it.
+ *
+ * @param name Pointer to the name characters.
+ * @param length Number of characters in the name.
+ * @param bean Receives the decoded bean type on success.
+ * @return true if the name is a valid bean name, false otherwise.
+ */
+bool CardFactory::decodeBean(const char *name, std::size_t length, BeanId &bean) noexcept
 {
-    auto deck = std::make_unique<Deck>();
-    std::vector<std::unique_ptr<Card>> allCards;
-    allCards.reserve(104); // Total number of cards
+    const char *expected = nullptr;
+    BeanId candidate = BeanId::Blue;
 
-    for (const auto &pair : cards)
+    switch (length)
     {
-        const auto &cardVec = pair.second;
-        for (const auto &card : cardVec)
+    case 3:
+        if (name[0] == 'S')      { expected = "Soy";    candidate = BeanId::Soy; }
+        else if (name[0] == 'R') { expected = "Red";    candidate = BeanId::Red; }
+        break;
+    case 4:
+        expected = "Blue"; candidate = BeanId::Blue;
+        break;
+    case 5:
+        switch (name[0])
         {
-            allCards.push_back(std::unique_ptr<Card>(card->clone()));
+        case 'C': expected = "Chili"; candidate = BeanId::Chili; break;
+        case 'S': expected = "Stink"; candidate = BeanId::Stink; break;
+        case 'G': expected = "Green"; candidate = BeanId::Green; break;
+        case 'B': expected = "Black"; candidate = BeanId::Black; break;
+        default: break;
         }
+        break;
+    case 6:
+        expected = "Garden"; candidate = BeanId::Garden;
+        break;
+    default:
+        break;
     }
 
-    // Shuffle using current time as seed
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::shuffle(allCards.begin(), allCards.end(), std::default_random_engine(seed));
-
-    for (auto &card : allCards)
+    if (!expected || std::memcmp(name, expected, length) != 0)
     {
-        deck->addCard(std::move(card));
+        return false;
     }
-
-    return deck;
+    bean = candidate;
+    return true;
 }
 
 /**
- * @brief Create a single card by its name, used during game loading.
+ * @brief Get a single card by its name, used during game loading.
  * @param cardName Name of the card to create.
- * @return A unique_ptr to the newly created card.
+ * @return Pointer to the shared instance of that bean type.
  * @throws std::runtime_error if the card name is invalid.
  */
-std::unique_ptr<Card> CardFactory::createCard(const std::string &cardName)
+const Card *CardFactory::createCard(const std::string &cardName) const
 {
-    auto createSpecificCard = [](const std::string &name) -> std::unique_ptr<Card>
+    BeanId bean;
+    if (!decodeBean(cardName, bean))
     {
-        if (name == "Blue")   return BeanCreator<Blue>::create();
-        if (name == "Chili")  return BeanCreator<Chili>::create();
-        if (name == "Stink")  return BeanCreator<Stink>::create();
-        if (name == "Green")  return BeanCreator<Green>::create();
-        if (name == "Soy")    return BeanCreator<Soy>::create();
-        if (name == "Black")  return BeanCreator<Black>::create();
-        if (name == "Red")    return BeanCreator<Red>::create();
-        if (name == "Garden") return BeanCreator<Garden>::create();
-        return nullptr;
-    };
-
-    if (cards.find(cardName) != cards.end())
-    {
-        auto card = createSpecificCard(cardName);
-        if (card)
-            return card;
+        throw std::runtime_error("Unable to create card: " + cardName);
     }
-
-    throw std::runtime_error("Unable to create card: " + cardName);
+    return Card::get(bean);
 }
@@ -0,0 +1,203 @@
+#include "CardTracker.h"
+#include <algorithm>
+#include "CardFactory.h"
+
+// The binomial table itself; the declaration in CardTracker.h holds the initializer
+constexpr card_tracker_detail::Binomials CardTracker::binomials;
+
+/**
+ * @brief Constructs a tracker for a player of a new game
+ *
+ * @param observer The player whose view is tracked (1 or 2)
+ * @throws std::out_of_range if observer is invalid
+ *
+ * Every card starts unseen and in the deck.
+ */
+CardTracker::CardTracker(int observer) : observer(static_cast<std::uint8_t>(observer - 1))
+{
+    GameState::validatePlayerNum(observer);
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        unseenCounts[b] = static_cast<std::uint8_t>(CardFactory::cardsOf(static_cast<BeanId>(b)));
+    }
+    totalUnseen = NUM_CARDS;
+    cardsInDeck = NUM_CARDS;
+}
+
+/**
+ * @brief Recounts the unseen cards from a table
+ *
+ * @param state The table
+ */
+void CardTracker::reset(const GameState &state)
+{
+    const Hand &hand = state.players[1 - observer].getHand();
+    totalUnseen = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        unseenCounts[b] = static_cast<std::uint8_t>(state.deck.remaining(static_cast<BeanId>(b)));
+    }
+    for (int i = 0; i < static_cast<int>(hand.size()); ++i)
+    {
+        ++unseenCounts[static_cast<int>(hand.beanAt(i))];
+    }
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        totalUnseen += unseenCounts[b];
+    }
+    cardsInDeck = static_cast<int>(state.deck.size());
+    numKnown = 0;
+}
+
+/**
+ * @brief Follows one change to the table
+ *
+ * @param change The change, as written by the GameEngine
+ *
+ * Only changes that move a card out of the deck or out of the opponent's hand
+ * matter; everything else moves cards between places the observer can see.
+ */
+void CardTracker::observe(const Journal::Record &change)
+{
+    bool own = change.player == observer;
+
+    switch (change.op)
+    {
+    case Journal::Op::DrawToHand:
+        --cardsInDeck;
+        if (own)
+        {
+            reveal(change.bean);
+        }
+        break;
+
+    case Journal::Op::DeckToTrade:
+        --cardsInDeck;
+        reveal(change.bean);
+        break;
+
+    case Journal::Op::PlayFromHand:
+        if (!own)
+        {
+            if (numKnown > 0)
+            {
+                --numKnown; // The front card was the one put back
+            }
+            else
+            {
+                reveal(change.bean);
+            }
+        }
+        break;
+
+    case Journal::Op::AddToFront:
+        if (!own)
+        {
+            known[numKnown++] = change.bean;
+        }
+        break;
+
+    case Journal::Op::RemoveFromHand:
+        if (!own)
+        {
+            if (change.a < numKnown)
+            {
+                // Hand index a is known[numKnown - 1 - a]
+                std::copy(known.begin() + numKnown - change.a, known.begin() + numKnown,
+                          known.begin() + numKnown - 1 - change.a);
+                --numKnown;
+            }
+            else
+            {
+                reveal(change.bean);
+            }
+        }
+        break;
+
+    case Journal::Op::TakeFromTrade:
+    case Journal::Op::Discard:
+    case Journal::Op::DiscardToTrade:
+    case Journal::Op::Harvest:
+    case Journal::Op::AddToChain:
+    case Journal::Op::BuyField:
+    case Journal::Op::NextPlayer:
+        break;
+    }
+}
+
+/**
+ * @brief Marks a card as seen
+ *
+ * @param bean Bean type of the card
+ */
+void CardTracker::reveal(BeanId bean)
+{
+    int b = static_cast<int>(bean);
+    if (unseenCounts[b] > 0)
+    {
+        --unseenCounts[b];
+        --totalUnseen;
+    }
+}
+
+/**
+ * @brief Clamps a number of draws to what the deck and the unseen cards allow
+ *
+ * @param draws Number of draws asked about
+ * @return A number between 0 and the smaller of the deck size and the unseen cards
+ */
+int CardTracker::clampDraws(int draws) const
+{
+    return std::max(0, std::min(draws, std::min(cardsInDeck, totalUnseen)));
+}
+
+/**
+ * @brief Probability that at least one card of a bean comes up in the next draws
+ *
+ * @param bean The bean type
+ * @param draws Number of cards to draw
+ * @return 1 - C(U - u, k) / C(U, k) for U unseen cards, u of them of the bean, k draws
+ */
+double CardTracker::probabilityInNext(BeanId bean, int draws) const
+{
+    int k = clampDraws(draws);
+    int u = unseen(bean);
+    return 1.0 - binomials.c[totalUnseen - u][k] / binomials.c[totalUnseen][k];
+}
+
+/**
+ * @brief Probability that at least a number of cards of a bean come up in the next draws
+ *
+ * @param bean The bean type
+ * @param count Number of cards of that bean wanted
+ * @param draws Number of cards to draw
+ * @return The upper tail of the hypergeometric distribution
+ */
+double CardTracker::probabilityAtLeast(BeanId bean, int count, int draws) const
+{
+    int k = clampDraws(draws);
+    int u = unseen(bean);
+    if (count <= 0)
+    {
+        return 1.0;
+    }
+
+    double hits = 0;
+    for (int j = count; j <= std::min(k, u); ++j)
+    {
+        hits += binomials.c[u][j] * binomials.c[totalUnseen - u][k - j];
+    }
+    return hits / binomials.c[totalUnseen][k];
+}
+
+/**
+ * @brief Expected number of cards of a bean in the next draws
+ *
+ * @param bean The bean type
+ * @param draws Number of cards to draw
+ * @return k * u / U, 0 if nothing is unseen
+ */
+double CardTracker::expectedInNext(BeanId bean, int draws) const
+{
+    return totalUnseen == 0 ? 0.0 : static_cast<double>(clampDraws(draws)) * unseen(bean) / totalUnseen;
+}
@@ -0,0 +1,126 @@
+#include "Chain.h"
+#include <limits>
+#include <stdexcept>
+#include "TextReader.h"
+
+/**
+ * @brief Constructs a chain from a saved game state
+ *
+ * @param in Input stream containing serialized chain data
+ * @param bean The bean type read from the chain type line
+ * @param factory Pointer to the CardFactory used to create cards
+ * @throws IllegalType if a saved card does not match the chain type
+ * @throws std::runtime_error if the card count is missing, not between 1 and the
+ *         beanometer's length or not followed by that many card lines, or the END_CHAIN
+ *         marker is missing
+ *
+ * Reads the card count, then one card name per line, then "END_CHAIN".
+ */
+Chain_Base::Chain_Base(std::istream &in, BeanId bean, const CardFactory *factory)
+    : type(bean)
+{
+    int chainSize;
+    if (!(in >> chainSize))
+    {
+        throw std::runtime_error("Invalid chain format: missing card count");
+    }
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    if (chainSize <= 0 || chainSize > Beanometer::MAX_CHAIN_LENGTH)
+    {
+        throw std::runtime_error("Invalid chain length in save: " + std::to_string(chainSize) + " cards");
+    }
+
+    for (int i = 0; i < chainSize; ++i)
+    {
+        std::string cardName;
+        if (!std::getline(in, cardName) || cardName.empty())
+        {
+            throw std::runtime_error("Invalid chain format: " + std::to_string(i) + " of " +
+                                     std::to_string(chainSize) + " cards before a blank line or the end");
+        }
+        *this += factory->createCard(cardName);
+    }
+
+    std::string endChain;
+    std::getline(in, endChain);
+    if (endChain != "END_CHAIN")
+    {
+        throw std::runtime_error("Invalid chain format: missing END_CHAIN");
+    }
+}
+
+/**
+ * @brief Constructs a chain by parsing a text save in place
+ *
+ * @param in Reader positioned after the chain type line
+ * @param bean The bean type read from the chain type line
+ * @throws IllegalType if a saved card does not match the chain type
+ * @throws std::runtime_error if the data is malformed, the chain is empty or longer
+ *         than the beanometer, or the END_CHAIN marker is missing
+ */
+Chain_Base::Chain_Base(TextReader &in, BeanId bean)
+    : type(bean)
+{
+    int chainSize = in.number();
+    if (chainSize == 0 || chainSize > Beanometer::MAX_CHAIN_LENGTH)
+    {
+        throw std::runtime_error("Invalid chain length in text save: " + std::to_string(chainSize) + " cards");
+    }
+    for (int i = 0; i < chainSize; ++i)
+    {
+        *this += Card::get(in.bean());
+    }
+    in.expect("END_CHAIN");
+}
+
+/**
+ * @brief Adds a card to the chain
+ *
+ * @param card Pointer to the card being added
+ * @return Reference to the modified chain
+ * @throws IllegalType if the card is null or not of the chain's bean type
+ */
+Chain_Base &Chain_Base::operator+=(const Card *card)
+{
+    if (!card || card->getId() != type)
+    {
+        throw IllegalType();
+    }
+    ++count;
+    return *this;
+}
+
+/**
+ * @brief Prints the chain type followed by one symbol per card
+ *
+ * @param out Output stream to print to
+ */
+void Chain_Base::print(std::ostream &out) const
+{
+    const Card *card = Card::get(type);
+    out << card->getName() << " ";
+    for (int i = 0; i < count; ++i)
+    {
+        card->print(out);
+        out << " ";
+    }
+}
+
+/**
+ * @brief Serializes the chain to an output stream
+ *
+ * @param out Output stream to write to
+ *
+ * Writes the chain type, the card count, each card's name and "END_CHAIN".
+ */
+void Chain_Base::serialize(std::ostream &out) const
+{
+    const std::string name = getType();
+    out << name << "\n";
+    out << size() << "\n";
+    for (int i = 0; i < count; ++i)
+    {
+        out << name << "\n";
+    }
+    out << "END_CHAIN\n";
+}
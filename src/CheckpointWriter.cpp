@@ -0,0 +1,191 @@
+#include "CheckpointWriter.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "BinaryIO.h"
+#include "Table.h"
+
+constexpr std::uint8_t CheckpointWriter::MAGIC[4];
+
+/**
+ * @brief Constructs a writer with no base yet
+ *
+ * @param compactEvery A full save is written every this many checkpoints
+ * @throws std::invalid_argument if compactEvery is less than 1
+ */
+CheckpointWriter::CheckpointWriter(int compactEvery)
+    : compactEvery(compactEvery), baseHash(0)
+{
+    if (compactEvery < 1)
+    {
+        throw std::invalid_argument("Checkpoints per full save must be at least 1");
+    }
+}
+
+/**
+ * @brief Writes a checkpoint of a table
+ *
+ * @param table The table
+ * @param out Buffer the checkpoint is appended to
+ * @return true if it is a full save; false for a delta
+ * @throws std::length_error if a section does not fit the format
+ */
+bool CheckpointWriter::checkpoint(const Table &table, std::vector<std::uint8_t> &out)
+{
+    const GameState &state = table.getState();
+    if (sinceBase < 0 || sinceBase + 1 >= compactEvery)
+    {
+        table.saveBinary(out);
+        base = state;
+        baseHash = state.hash();
+        sinceBase = 0;
+        return true;
+    }
+
+    ByteWriter writer(out);
+    writer.bytes(reinterpret_cast<const char *>(MAGIC), sizeof(MAGIC));
+    writer.byte(VERSION);
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        writer.byte(static_cast<int>(baseHash >> shift & 0xFF));
+    }
+    writer.byte(state.currentPlayer);
+
+    int changed = 0;
+    for (int p = 0; p < 2; ++p)
+    {
+        if (state.players[p].changedSince(base.players[p]))
+        {
+            changed |= p == 0 ? Player1 : Player2;
+        }
+    }
+    if (state.deck.changedSince(base.deck))
+    {
+        changed |= DeckCards;
+    }
+    if (state.discardPile.changedSince(base.discardPile))
+    {
+        changed |= Discards;
+    }
+    if (state.tradeArea.changedSince(base.tradeArea))
+    {
+        changed |= Trade;
+    }
+    writer.byte(changed);
+
+    for (int p = 0; p < 2; ++p)
+    {
+        if (changed & (p == 0 ? Player1 : Player2))
+        {
+            state.players[p].writeBinary(writer);
+        }
+    }
+    if (changed & DeckCards)
+    {
+        state.deck.writeDelta(writer, base.deck);
+    }
+    if (changed & Discards)
+    {
+        state.discardPile.writeDelta(writer, base.discardPile);
+    }
+    if (changed & Trade)
+    {
+        state.tradeArea.writeBinary(writer);
+    }
+
+    ++sinceBase;
+    return false;
+}
+
+/**
+ * @brief Checks if a checkpoint is a delta
+ *
+ * @param data First byte of the checkpoint
+ * @param size Number of bytes
+ * @return true if the data starts with the delta magic number
+ */
+bool CheckpointWriter::isDelta(const std::uint8_t *data, std::size_t size)
+{
+    return size >= sizeof(MAGIC) && std::equal(MAGIC, MAGIC + sizeof(MAGIC), data);
+}
+
+/**
+ * @brief Rebuilds a table from its last full save and a delta written against it
+ *
+ * @param base First byte of the full save
+ * @param baseSize Number of bytes in the full save
+ * @param delta First byte of the delta, nullptr to restore the full save alone
+ * @param deltaSize Number of bytes in the delta
+ * @return The table
+ * @throws std::runtime_error if either is malformed or the delta belongs to another base
+ *
+ * Sections the delta leaves out keep their state from the full save.
+ */
+Table CheckpointWriter::restore(const std::uint8_t *base, std::size_t baseSize, const std::uint8_t *delta,
+                                std::size_t deltaSize)
+{
+    Table table(base, baseSize);
+    if (!delta)
+    {
+        return table;
+    }
+    if (!isDelta(delta, deltaSize))
+    {
+        throw std::runtime_error("Not a checkpoint delta");
+    }
+
+    ByteReader in(delta + sizeof(MAGIC), deltaSize - sizeof(MAGIC));
+    int version = in.byte();
+    if (version != VERSION)
+    {
+        throw std::runtime_error("Unsupported checkpoint delta version: " + std::to_string(version));
+    }
+    std::uint64_t hash = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        hash |= static_cast<std::uint64_t>(in.byte()) << shift;
+    }
+
+    GameState &state = table.getState();
+    if (hash != state.hash())
+    {
+        throw std::runtime_error("Checkpoint delta was written against another full save");
+    }
+
+    int current = in.byte();
+    if (current != 1 && current != 2)
+    {
+        throw std::runtime_error("Invalid current player in checkpoint delta: " + std::to_string(current));
+    }
+    state.currentPlayer = static_cast<std::uint8_t>(current);
+
+    int changed = in.byte();
+    if (changed & ~(Player1 | Player2 | DeckCards | Discards | Trade))
+    {
+        throw std::runtime_error("Unknown section in checkpoint delta");
+    }
+    for (int p = 0; p < 2; ++p)
+    {
+        if (changed & (p == 0 ? Player1 : Player2))
+        {
+            state.players[p] = Player(in);
+        }
+    }
+    if (changed & DeckCards)
+    {
+        state.deck = Deck(in, state.deck);
+    }
+    if (changed & Discards)
+    {
+        state.discardPile = DiscardPile(in, state.discardPile);
+    }
+    if (changed & Trade)
+    {
+        state.tradeArea = TradeArea(in);
+    }
+    if (in.remaining() != 0)
+    {
+        throw std::runtime_error("Checkpoint delta has trailing bytes");
+    }
+    return table;
+}
@@ -0,0 +1,259 @@
+#include "CorpusLoader.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "CardFactory.h"
+#include "MappedFile.h"
+#include "Table.h"
+
+#ifndef _WIN32
+#include <glob.h>
+#include <sys/stat.h>
+#endif
+
+constexpr const char *CorpusLoader::DEFAULT_PATTERN;
+constexpr std::size_t CorpusLoader::CHUNK;
+
+namespace
+{
+/**
+ * @brief Checks that a table holds no more cards of any bean than the game has
+ *
+ * @param state The table's state
+ * @return Number of cards on the table
+ * @throws std::runtime_error naming the first bean with too many cards
+ *
+ * Counts the cards of each bean in the deck, the discard pile, the trade area and both
+ * players' hands and fields, and holds each count to CardFactory::cardsOf().
+ */
+std::size_t checkCards(const GameState &state)
+{
+    std::array<int, NUM_BEAN_TYPES> counts{};
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId bean = static_cast<BeanId>(b);
+        counts[b] = state.deck.remaining(bean) + state.tradeArea.count(bean);
+    }
+    for (std::size_t i = 0; i < state.discardPile.size(); ++i)
+    {
+        ++counts[static_cast<int>(state.discardPile.beanAt(i))];
+    }
+    for (const Player &player : state.players)
+    {
+        const Hand &hand = player.getHand();
+        for (int i = 0; i < static_cast<int>(hand.size()); ++i)
+        {
+            ++counts[static_cast<int>(hand.beanAt(i))];
+        }
+        for (int i = 0; i < player.getMaxNumChains(); ++i)
+        {
+            const Chain_Base &chain = player[i];
+            if (!chain.empty())
+            {
+                counts[static_cast<int>(chain.getBeanId())] += chain.size();
+            }
+        }
+    }
+
+    std::size_t cards = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId bean = static_cast<BeanId>(b);
+        if (counts[b] > CardFactory::cardsOf(bean))
+        {
+            throw std::runtime_error("Save holds " + std::to_string(counts[b]) + " " + Card::get(bean)->getName() +
+                                     " cards, more than the " + std::to_string(CardFactory::cardsOf(bean)) +
+                                     " in the game");
+        }
+        cards += static_cast<std::size_t>(counts[b]);
+    }
+    return cards;
+}
+
+/**
+ * @brief What one worker loaded
+ */
+struct Partial
+{
+    std::size_t files = 0;                                           ///< Files loaded
+    std::size_t bytes = 0;                                           ///< Bytes read
+    std::size_t cards = 0;                                           ///< Cards on the tables
+    std::vector<std::pair<std::size_t, CorpusLoader::Error>> errors; ///< Failed files by index
+};
+}
+
+/**
+ * @brief Constructs a loader
+ *
+ * @param threads Number of worker threads, 0 for one per core
+ */
+CorpusLoader::CorpusLoader(unsigned threads)
+    : threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+/**
+ * @brief Lists the saves of a corpus
+ *
+ * @param where A directory or a glob pattern
+ * @return The paths, sorted
+ * @throws std::runtime_error if the pattern cannot be read or matches nothing
+ *
+ * Directories that match the pattern are left out.
+ */
+std::vector<std::string> CorpusLoader::list(const std::string &where)
+{
+#ifdef _WIN32
+    throw std::runtime_error("Listing a save corpus needs POSIX glob(): " + where);
+#else
+    std::string pattern = where;
+    struct stat info;
+    if (::stat(where.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+    {
+        pattern += (pattern.empty() || pattern.back() != '/') ? "/" : "";
+        pattern += DEFAULT_PATTERN;
+    }
+
+    glob_t matches;
+    int status = ::glob(pattern.c_str(), GLOB_MARK, nullptr, &matches);
+    if (status != 0)
+    {
+        ::globfree(&matches);
+        throw std::runtime_error((status == GLOB_NOMATCH ? "No saves match: " : "Could not read: ") + pattern);
+    }
+
+    std::vector<std::string> paths;
+    paths.reserve(matches.gl_pathc);
+    for (std::size_t i = 0; i < matches.gl_pathc; ++i)
+    {
+        std::string path = matches.gl_pathv[i];
+        if (path.back() != '/')
+        {
+            paths.push_back(std::move(path));
+        }
+    }
+    ::globfree(&matches);
+
+    if (paths.empty())
+    {
+        throw std::runtime_error("No saves match: " + pattern);
+    }
+    return paths;
+#endif
+}
+
+/**
+ * @brief Loads files, passing each table to a visitor
+ *
+ * @param paths Files to load
+ * @param visit Visitor of the loaded tables, may be empty
+ * @return Totals and per-file errors
+ *
+ * Workers claim CHUNK files at a time from a shared counter. Each keeps its own totals
+ * and errors, which are merged once all have finished.
+ */
+CorpusLoader::Report CorpusLoader::load(const std::vector<std::string> &paths, const Visitor &visit) const
+{
+    std::atomic<std::size_t> next(0);
+    auto work = [&](Partial &partial)
+    {
+        for (;;)
+        {
+            std::size_t first = next.fetch_add(CHUNK);
+            if (first >= paths.size())
+            {
+                return;
+            }
+            std::size_t last = std::min(first + CHUNK, paths.size());
+            for (std::size_t i = first; i < last; ++i)
+            {
+                try
+                {
+                    MappedFile file(paths[i]);
+                    Table table(file.data(), file.size());
+
+                    std::size_t cards = checkCards(table.getState());
+                    if (visit)
+                    {
+                        visit(i, table);
+                    }
+
+                    ++partial.files;
+                    partial.bytes += file.size();
+                    partial.cards += cards;
+                }
+                catch (const std::exception &e)
+                {
+                    partial.errors.emplace_back(i, Error{paths[i], e.what()});
+                }
+            }
+        }
+    };
+
+    unsigned workers = static_cast<unsigned>(std::min<std::size_t>(threads, (paths.size() + CHUNK - 1) / CHUNK));
+    std::vector<Partial> partials(std::max(1u, workers));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < workers; ++t)
+    {
+        pool.emplace_back(work, std::ref(partials[t]));
+    }
+    work(partials[0]);
+    for (std::thread &worker : pool)
+    {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Report report;
+    report.seconds = elapsed.count();
+    std::vector<std::pair<std::size_t, Error>> errors;
+    for (Partial &partial : partials)
+    {
+        report.files += partial.files;
+        report.bytes += partial.bytes;
+        report.cards += partial.cards;
+        std::move(partial.errors.begin(), partial.errors.end(), std::back_inserter(errors));
+    }
+    std::sort(errors.begin(), errors.end(),
+              [](const std::pair<std::size_t, Error> &a, const std::pair<std::size_t, Error> &b)
+              { return a.first < b.first; });
+    for (std::pair<std::size_t, Error> &error : errors)
+    {
+        report.errors.push_back(std::move(error.second));
+    }
+    return report;
+}
+
+/**
+ * @brief Loads files and keeps their tables
+ *
+ * @param paths Files to load
+ * @param tables Receives the tables of the files that loaded, in the order given
+ * @return Totals and per-file errors
+ *
+ * Each file has its own slot, so the workers store their tables without locking.
+ */
+CorpusLoader::Report CorpusLoader::load(const std::vector<std::string> &paths, std::vector<Table> &tables) const
+{
+    std::vector<std::unique_ptr<Table>> slots(paths.size());
+    Report report = load(paths, [&slots](std::size_t i, Table &table)
+                         { slots[i] = std::make_unique<Table>(std::move(table)); });
+
+    tables.reserve(tables.size() + report.files);
+    for (std::unique_ptr<Table> &slot : slots)
+    {
+        if (slot)
+        {
+            tables.push_back(std::move(*slot));
+        }
+    }
+    return report;
+}
@@ -1,69 +1,173 @@
 #include "Deck.h"
-#include <algorithm>
 #include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include "BinaryIO.h"
 #include "CardFactory.h"
+#include "TextReader.h"
+
+/**
+ * @brief Construct a Deck from bean ids, bottom card first.
+ * @param beans The cards in the deck.
+ * @param count Number of cards.
+ * @throws std::length_error if count exceeds NUM_CARDS.
+ */
+Deck::Deck(const BeanId *beans, std::size_t count)
+{
+    if (count > cards.size())
+    {
+        throw std::length_error("Deck cannot hold more than " + std::to_string(NUM_CARDS) + " cards");
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        cards[i] = beans[i];
+        ++beanCounts[static_cast<int>(beans[i])];
+    }
+    cursor = static_cast<std::uint8_t>(count);
+    rehash();
+}
+
+/**
+ * @brief Recompute the hash from the remaining cards.
+ */
+void Deck::rehash()
+{
+    hashValue = 0;
+    for (int i = 0; i < cursor; ++i)
+    {
+        hashValue ^= zobrist::key(zobrist::Part::Deck, i, cards[i]);
+    }
+}
 
 /**
  * @brief Construct a Deck from saved data in a stream. Reads card names until "END_DECK".
  * @param in Input stream containing deck data.
  * @param factory CardFactory to recreate cards from names.
+ * @throws std::runtime_error if a card name is unknown or the input ends before END_DECK.
  */
 Deck::Deck(std::istream &in, const CardFactory *factory)
 {
-    cards.clear();
     std::string cardName;
+    bool ended = false;
 
     while (std::getline(in, cardName))
     {
         if (cardName == "END_DECK")
         {
+            ended = true;
             break;
         }
 
         try
         {
-            auto card = factory->getFactory()->createCard(cardName);
-            if (card)
-            {
-                cards.push_back(std::move(card));
-            }
+            addCard(factory->createCard(cardName));
+        }
+        catch (const std::runtime_error &e)
+        {
+            throw std::runtime_error(std::string("Error loading deck: ") + e.what());
         }
-        catch (const std::exception &e)
+    }
+
+    if (!ended)
+    {
+        throw std::runtime_error("Invalid deck format: missing END_DECK");
+    }
+}
+
+/**
+ * @brief Construct a Deck from a binary save.
+ * @param in Reader positioned at the deck.
+ * @throws std::runtime_error if the data is malformed.
+ */
+Deck::Deck(ByteReader &in)
+{
+    int size = in.byte();
+    if (size > NUM_CARDS)
+    {
+        throw std::runtime_error("Deck too large in binary save: " + std::to_string(size));
+    }
+
+    BeanId beans[NUM_CARDS];
+    in.beans(beans, size);
+    *this = Deck(beans, size);
+}
+
+/**
+ * @brief Construct a Deck by parsing a text save in place.
+ * @param in Reader positioned at the deck.
+ * @throws std::runtime_error if a card is unknown or the END_DECK marker is missing.
+ * @throws std::length_error if the deck holds more than NUM_CARDS cards.
+ */
+Deck::Deck(TextReader &in)
+{
+    BeanId beans[NUM_CARDS];
+    std::size_t size = 0;
+    for (TextSpan line = in.line(); line != "END_DECK"; line = in.line())
+    {
+        if (size == NUM_CARDS)
         {
-            std::cerr << "Error loading deck card: " << e.what() << std::endl;
+            throw std::length_error("Deck cannot hold more than " + std::to_string(NUM_CARDS) + " cards");
         }
+        beans[size++] = TextReader::bean(line);
     }
+    *this = Deck(beans, size);
 }
 
 /**
  * @brief Draw and remove the top card from the deck.
- * @return A unique_ptr to the drawn card.
+ * @return Pointer to the drawn card.
  * @throws std::runtime_error if the deck is empty.
  */
-std::unique_ptr<Card> Deck::draw()
+const Card *Deck::draw()
 {
-    if (cards.empty())
+    if (cursor == 0)
     {
         throw std::runtime_error("Cannot draw from empty deck");
     }
 
-    std::unique_ptr<Card> topCard = std::move(cards.back());
-    cards.pop_back();
-    return topCard;
+    BeanId topCard = cards[--cursor];
+    --beanCounts[static_cast<int>(topCard)];
+    hashValue ^= zobrist::key(zobrist::Part::Deck, cursor, topCard);
+    return Card::get(topCard);
+}
+
+/**
+ * @brief Look at a card without removing it from the deck.
+ * @param k Depth from the top (0 is the top card).
+ * @return Pointer to the card.
+ * @throws std::out_of_range if the deck has k or fewer cards.
+ */
+const Card *Deck::peek(std::size_t k) const
+{
+    if (k >= cursor)
+    {
+        std::ostringstream oss;
+        oss << "Cannot peek " << k << " cards deep. Deck size is " << static_cast<int>(cursor);
+        throw std::out_of_range(oss.str());
+    }
+    return Card::get(cards[cursor - 1 - k]);
 }
 
 /**
  * @brief Add a card to the top of the deck.
  * @param card The card to add. Must not be null.
  * @throws std::invalid_argument if card is null.
+ * @throws std::length_error if the deck is full.
  */
-void Deck::addCard(std::unique_ptr<Card> card)
+void Deck::addCard(const Card *card)
 {
     if (!card)
     {
         throw std::invalid_argument("Cannot add null card to deck");
     }
-    cards.push_back(std::move(card));
+    if (cursor == cards.size())
+    {
+        throw std::length_error("Cannot add card to full deck");
+    }
+    hashValue ^= zobrist::key(zobrist::Part::Deck, cursor, card->getId());
+    cards[cursor++] = card->getId();
+    ++beanCounts[static_cast<int>(card->getId())];
 }
 
 /**
@@ -72,16 +176,57 @@ void Deck::addCard(std::unique_ptr<Card> card)
  */
 void Deck::serialize(std::ostream &out) const
 {
-    for (const auto &card : cards)
+    for (int i = 0; i < cursor; ++i)
     {
-        if (card)
-        {
-            out << card->getName() << "\n";
-        }
+        out << Card::get(cards[i])->getName() << "\n";
     }
     out << "END_DECK\n";
 }
 
+/**
+ * @brief Write the deck to a binary save.
+ * @param out Writer to append to.
+ */
+void Deck::writeBinary(ByteWriter &out) const
+{
+    out.byte(cursor);
+    out.beans(cards.data(), cursor);
+}
+
+/**
+ * @brief Check if the deck differs from an earlier copy.
+ * @param base The earlier copy.
+ * @return true if the cards or their order differ.
+ */
+bool Deck::changedSince(const Deck &base) const
+{
+    return hashValue != base.hashValue || cursor != base.cursor ||
+           !std::equal(cards.begin(), cards.begin() + cursor, base.cards.begin());
+}
+
+/**
+ * @brief Write the deck as a change to an earlier copy.
+ * @param out Writer to append to.
+ * @param base The earlier copy.
+ */
+void Deck::writeDelta(ByteWriter &out, const Deck &base) const
+{
+    out.beanDelta(cards.data(), cursor, base.cards.data(), base.cursor);
+}
+
+/**
+ * @brief Construct a Deck from an earlier copy and a change writeDelta() wrote.
+ * @param in Reader positioned at the change.
+ * @param base The copy the change was written against.
+ * @throws std::runtime_error if the data is malformed or does not fit the base.
+ */
+Deck::Deck(ByteReader &in, const Deck &base)
+{
+    BeanId beans[NUM_CARDS];
+    std::size_t size = in.beanDelta(beans, NUM_CARDS, base.cards.data(), base.cursor);
+    *this = Deck(beans, size);
+}
+
 /**
  * @brief Overload of operator<< for decks. Prints the deck's cards in order.
  * @param out Output stream.
@@ -90,13 +235,10 @@ void Deck::serialize(std::ostream &out) const
  */
 std::ostream &operator<<(std::ostream &out, const Deck &deck)
 {
-    for (const auto &card : deck.cards)
+    for (int i = 0; i < deck.cursor; ++i)
     {
-        if (card)
-        {
-            card->print(out);
-            out << " ";
-        }
+        Card::get(deck.cards[i])->print(out);
+        out << " ";
     }
     return out;
 }
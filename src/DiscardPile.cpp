@@ -1,77 +1,124 @@
 #include "DiscardPile.h"
+#include "BinaryIO.h"
 #include "CardFactory.h"
+#include "TextReader.h"
 #include <stdexcept>
+#include <algorithm>
 
 /**
  * @brief Constructs a DiscardPile from a saved game state
  *
  * @param in Input stream containing serialized discard pile data
  * @param factory Pointer to the CardFactory used to create cards
+ * @throws std::runtime_error if a card name is unknown or the input ends before END_DISCARD
  *
  * Reads card names from the input stream until "END_DISCARD" is encountered.
  * Each card is recreated using the provided CardFactory.
  */
 DiscardPile::DiscardPile(std::istream &in, const CardFactory *factory)
 {
-    cards.clear();
     std::string cardName;
+    bool ended = false;
 
     while (std::getline(in, cardName))
     {
         if (cardName == "END_DISCARD")
         {
+            ended = true;
             break;
         }
 
         try
         {
             // Create card from saved name using factory
-            auto card = std::unique_ptr<Card>(factory->getFactory()->createCard(cardName));
-            if (card)
-            {
-                cards.push_back(std::move(card));
-            }
+            *this += factory->createCard(cardName);
         }
-        catch (const std::exception &e)
+        catch (const std::runtime_error &e)
         {
-            std::cerr << "Error loading discarded card: " << e.what() << std::endl;
+            throw std::runtime_error(std::string("Error loading discard pile: ") + e.what());
         }
     }
+
+    if (!ended)
+    {
+        throw std::runtime_error("Invalid discard pile format: missing END_DISCARD");
+    }
+}
+
+/**
+ * @brief Constructs a DiscardPile from a binary save
+ *
+ * @param in Reader positioned at the discard pile
+ * @throws std::runtime_error if the data is malformed
+ */
+DiscardPile::DiscardPile(ByteReader &in)
+{
+    int size = in.byte();
+    if (size > NUM_CARDS)
+    {
+        throw std::runtime_error("Discard pile too large in binary save: " + std::to_string(size));
+    }
+
+    BeanId beans[NUM_CARDS];
+    in.beans(beans, size);
+    for (int i = 0; i < size; ++i)
+    {
+        *this += Card::get(beans[i]);
+    }
+}
+
+/**
+ * @brief Constructs a DiscardPile by parsing a text save in place
+ *
+ * @param in Reader positioned at the discard pile
+ * @throws std::runtime_error if a card is unknown or the END_DISCARD marker is missing
+ */
+DiscardPile::DiscardPile(TextReader &in)
+{
+    for (TextSpan line = in.line(); line != "END_DISCARD"; line = in.line())
+    {
+        *this += Card::get(TextReader::bean(line));
+    }
 }
 
 /**
  * @brief Adds a card to the top of the discard pile
  *
- * @param card Unique pointer to the card being discarded
+ * @param card Pointer to the card being discarded
  * @return Reference to the modified DiscardPile
  * @throws std::invalid_argument if card pointer is null
+ * @throws std::length_error if the pile is full
  */
-DiscardPile &DiscardPile::operator+=(std::unique_ptr<Card> card)
+DiscardPile &DiscardPile::operator+=(const Card *card)
 {
     if (!card)
     {
         throw std::invalid_argument("Cannot add null card to discard pile");
     }
-    cards.push_back(std::move(card));
+    if (count == NUM_CARDS)
+    {
+        throw std::length_error("Cannot add card to full discard pile");
+    }
+    hashValue ^= zobrist::key(zobrist::Part::Discard, count, card->getId());
+    cards[count++] = card->getId();
     return *this;
 }
 
 /**
  * @brief Removes and returns the top card from the discard pile
  *
- * @return Unique pointer to the picked up card
+ * @return Pointer to the picked up card
  * @throws std::runtime_error if the discard pile is empty
  */
-std::unique_ptr<Card> DiscardPile::pickUp()
+const Card *DiscardPile::pickUp()
 {
-    if (cards.empty())
+    if (count == 0)
     {
         throw std::runtime_error("Cannot pick up from empty discard pile");
     }
-
-    std::unique_ptr<Card> topCard = std::move(cards.back());
-    cards.pop_back();
-    return topCard;
+    --count;
+    hashValue ^= zobrist::key(zobrist::Part::Discard, count, cards[count]);
+    return Card::get(cards[count]);
 }
 
 /**
@@ -82,21 +129,11 @@ std::unique_ptr<Card> DiscardPile::pickUp()
  */
 const Card *DiscardPile::top() const
 {
-    if (cards.empty())
+    if (count == 0)
     {
         throw std::runtime_error("Cannot get top card from empty discard pile");
     }
-    return cards.back().get();
-}
-
-/**
- * @brief Checks if the discard pile is empty
- *
- * @return true if pile contains no cards, false otherwise
- */
-bool DiscardPile::empty() const
-{
-    return cards.empty();
+    return Card::get(cards[count - 1]);
 }
 
 /**
@@ -131,16 +168,64 @@ void DiscardPile::print(std::ostream &out) const
  */
 void DiscardPile::serialize(std::ostream &out) const
 {
-    for (const auto &card : cards)
+    for (int i = 0; i < count; ++i)
     {
-        if (card)
-        {
-            out << card->getName() << "\n";
-        }
+        out << Card::get(cards[i])->getName() << "\n";
     }
     out << "END_DISCARD\n";
 }
 
+/**
+ * @brief Writes the discard pile to a binary save
+ *
+ * @param out Writer to append to
+ */
+void DiscardPile::writeBinary(ByteWriter &out) const
+{
+    out.byte(count);
+    out.beans(cards.data(), count);
+}
+
+/**
+ * @brief Checks if the pile differs from an earlier copy
+ *
+ * @param base The earlier copy
+ * @return true if the cards or their order differ
+ */
+bool DiscardPile::changedSince(const DiscardPile &base) const
+{
+    return hashValue != base.hashValue || count != base.count ||
+           !std::equal(cards.begin(), cards.begin() + count, base.cards.begin());
+}
+
+/**
+ * @brief Writes the pile as a change to an earlier copy
+ *
+ * @param out Writer to append to
+ * @param base The earlier copy
+ */
+void DiscardPile::writeDelta(ByteWriter &out, const DiscardPile &base) const
+{
+    out.beanDelta(cards.data(), count, base.cards.data(), base.count);
+}
+
+/**
+ * @brief Constructs a DiscardPile from an earlier copy and a change writeDelta() wrote
+ *
+ * @param in Reader positioned at the change
+ * @param base The copy the change was written against
+ * @throws std::runtime_error if the data is malformed or does not fit the base
+ */
+DiscardPile::DiscardPile(ByteReader &in, const DiscardPile &base)
+{
+    BeanId beans[NUM_CARDS];
+    std::size_t size = in.beanDelta(beans, NUM_CARDS, base.cards.data(), base.count);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        *this += Card::get(beans[i]);
+    }
+}
+
 /**
  * @brief Stream insertion operator for DiscardPile
  *
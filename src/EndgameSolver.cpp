@@ -0,0 +1,560 @@
+#include "EndgameSolver.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "GameEngine.h"
+#include "Zobrist.h"
+
+namespace
+{
+/** @brief Cards drawn from a discard to the next decision: trade area fill, end of turn draw, next turn's draw */
+constexpr int NUM_DRAWS = GameEngine::TRADE_AREA_DRAW + GameEngine::END_OF_TURN_DRAW + 1;
+
+/** @brief Largest deck at the start of a turn that the turn empties, making it the last */
+constexpr int LAST_TURN_DECK = GameEngine::TRADE_AREA_DRAW + GameEngine::END_OF_TURN_DRAW;
+
+/** @brief Phase key of the chance node after a discard, next to the TurnPhase keys */
+constexpr int CHANCE = static_cast<int>(TurnPhase::Over) + 1;
+
+/** @brief Phase keys of the last turn's decisions start here */
+constexpr int LAST_TURN = CHANCE + 1;
+
+/** @brief Most cards planted from the hand in a turn */
+constexpr int PLANTINGS = 2;
+
+/** @brief Transposition table entries looked at for a key */
+constexpr std::uint64_t PROBES = 4;
+
+/**
+ * @brief Hashes a position regardless of the order of its deck
+ *
+ * @param state The table
+ * @param phase The decision, or CHANCE
+ * @return A key other than 0
+ */
+std::uint64_t positionKey(const GameState &state, int phase)
+{
+    std::uint64_t key = state.hash() ^ state.deck.hash() ^ zobrist::key(zobrist::Part::Phase, phase);
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        key ^= zobrist::key(zobrist::Part::DeckCount, b, state.deck.remaining(static_cast<BeanId>(b)));
+    }
+    return key == 0 ? 1 : key;
+}
+
+/**
+ * @brief Hashes a decision of the last turn by what it depends on: the current player, the two
+ *        cards they can still plant from their hand, and the trade area
+ *
+ * @param state The table
+ * @param phase The decision
+ * @return A key other than 0, apart from the keys of positionKey()
+ */
+std::uint64_t lastTurnKey(const GameState &state, int phase)
+{
+    const Hand &hand = state.current().getHand();
+    std::uint64_t key = state.current().hash() ^ hand.hash() ^ state.tradeArea.hash() ^
+                        zobrist::key(zobrist::Part::Turn, state.currentPlayer) ^
+                        zobrist::key(zobrist::Part::Phase, LAST_TURN + phase);
+    for (int i = 0; i < static_cast<int>(hand.size()) && i < PLANTINGS; ++i)
+    {
+        key ^= zobrist::key(zobrist::Part::Hand, i, hand.beanAt(i));
+    }
+    return key == 0 ? 1 : key;
+}
+
+/**
+ * @brief Keeps only the action of a last turn decision that is known to be best, if there is one
+ *
+ * @param state The table, in the last turn
+ * @param phase The decision
+ * @param moves The actions of the decision, left with the ones to search
+ *
+ * In the last turn a card that joins a chain already planted is always worth taking: the
+ * chain only grows, or is sold at its highest value when full, and no field is taken up
+ * that a later card could have used. Planting the second card costs nothing either, as no
+ * card comes after it, and the harvest that follows is best spent on the richest field.
+ */
+void pruneLastTurn(const GameState &state, TurnPhase phase, MoveList &moves)
+{
+    const Player &player = state.current();
+    int keep = -2;
+    switch (phase)
+    {
+    case TurnPhase::TakeTrade:
+    {
+        BeanMask growing = MoveGen::tradeMoves(state) & MoveGen::plantedBeans(player);
+        for (int action : moves)
+        {
+            if (action >= 0 && (growing & beanBit(static_cast<BeanId>(action))))
+            {
+                keep = action;
+                break;
+            }
+        }
+        break;
+    }
+
+    case TurnPhase::PlantSecond:
+        keep = moves[moves.size() - 1];
+        break;
+
+    case TurnPhase::Harvest:
+    {
+        int coins = 0;
+        for (int action : moves)
+        {
+            if (action >= 0 && player[action].sell() > coins)
+            {
+                keep = action;
+                coins = player[action].sell();
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (keep != -2)
+    {
+        moves.clear();
+        moves.push(keep);
+    }
+}
+
+/**
+ * @brief Player 1's coins less player 2's
+ */
+double margin(const GameState &state)
+{
+    return state.players[0].getNumCoins() - state.players[1].getNumCoins();
+}
+} // namespace
+
+/**
+ * @brief The cards drawn between a discard and the next decision, in draw order
+ */
+struct EndgameSolver::Draws
+{
+    BeanId beans[NUM_DRAWS];         ///< Bean drawn at each position
+    bool skipped[NUM_DRAWS];         ///< Positions whose bean cannot change the result
+    int counts[NUM_BEAN_TYPES];      ///< Cards per bean left after the dealt positions
+    int left;                        ///< Cards left after the dealt positions
+    double probability;              ///< Chance of the beans dealt so far
+};
+
+/**
+ * @brief Constructs a solver
+ *
+ * @param threshold Positions are solved while the deck holds fewer cards than this
+ * @param tableBits Log2 of the number of transposition table entries
+ * @throws std::invalid_argument if tableBits is 0 or above 30
+ */
+EndgameSolver::EndgameSolver(int threshold, unsigned tableBits) : threshold(threshold)
+{
+    if (tableBits == 0 || tableBits > 30)
+    {
+        throw std::invalid_argument("Transposition table size out of range");
+    }
+    table.resize(std::size_t(1) << tableBits);
+    mask = table.size() - 1;
+}
+
+/**
+ * @brief Forgets every memoized value
+ */
+void EndgameSolver::clear()
+{
+    std::fill(table.begin(), table.end(), Entry());
+    nodes = 0;
+}
+
+/**
+ * @brief Throws if the solver does not cover the position
+ *
+ * @param state The table
+ * @throws std::invalid_argument if the deck holds threshold cards or more
+ */
+void EndgameSolver::check(const GameState &state) const
+{
+    if (!covers(state))
+    {
+        throw std::invalid_argument("Deck too large for the endgame solver: " + std::to_string(state.deck.size()) +
+                                    " cards, threshold " + std::to_string(threshold));
+    }
+}
+
+/**
+ * @brief Looks up a position key
+ *
+ * @param key The key
+ * @param value Set to the memoized value if found
+ * @return false if the key is not in the table
+ */
+bool EndgameSolver::probe(std::uint64_t key, double &value) const
+{
+    for (std::uint64_t i = 0; i < PROBES; ++i)
+    {
+        const Entry &entry = table[(key + i) & mask];
+        if (entry.key == key)
+        {
+            value = entry.value;
+            return true;
+        }
+        if (entry.key == 0)
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Memoizes the value of a position key
+ *
+ * @param key The key
+ * @param value The value
+ *
+ * Takes the first free entry among the probed ones; when all are taken, the first is replaced.
+ */
+void EndgameSolver::store(std::uint64_t key, double value)
+{
+    Entry *slot = &table[key & mask];
+    for (std::uint64_t i = 0; i < PROBES; ++i)
+    {
+        Entry &entry = table[(key + i) & mask];
+        if (entry.key == 0 || entry.key == key)
+        {
+            slot = &entry;
+            break;
+        }
+    }
+    slot->key = key;
+    slot->value = value;
+}
+
+/**
+ * @brief Solves a decision of the current player
+ *
+ * @param state The table, with both hands known
+ * @param phase The decision
+ * @return The expected final margin for player 1
+ * @throws std::invalid_argument if the solver does not cover the position
+ */
+double EndgameSolver::value(const GameState &state, TurnPhase phase)
+{
+    check(state);
+    return search(state, phase);
+}
+
+/**
+ * @brief Solves a decision after one of its actions
+ *
+ * @param state The table, with both hands known
+ * @param phase The decision
+ * @param action One of the actions MoveGen::generate() lists for it
+ * @return The expected final margin for player 1
+ * @throws std::invalid_argument if the solver does not cover the position
+ */
+double EndgameSolver::actionValue(const GameState &state, TurnPhase phase, int action)
+{
+    check(state);
+    return phase == TurnPhase::Over ? margin(state) : after(state, phase, action);
+}
+
+/**
+ * @brief Finds the best action of a decision of the current player
+ *
+ * @param state The table, with both hands known
+ * @param phase The decision
+ * @param value Set to the expected final margin for player 1, unless nullptr
+ * @return The action; the first listed of equally good ones, -1 if the game is over
+ * @throws std::invalid_argument if the solver does not cover the position
+ */
+int EndgameSolver::bestAction(const GameState &state, TurnPhase phase, double *value)
+{
+    check(state);
+    MoveList moves;
+    int n = MoveGen::generate(state, phase, moves);
+    int best = -1;
+    double bestValue = margin(state);
+    for (int i = 0; i < n; ++i)
+    {
+        double v = after(state, phase, moves[i]);
+        if (i == 0 || (state.currentPlayer == 1 ? v > bestValue : v < bestValue))
+        {
+            best = moves[i];
+            bestValue = v;
+        }
+    }
+    if (value)
+    {
+        *value = bestValue;
+    }
+    return best;
+}
+
+/**
+ * @brief Solves the start of the current player's turn, before their first draw
+ *
+ * @param state The table, with both hands known
+ * @return The expected final margin for player 1, averaged over the card drawn
+ * @throws std::invalid_argument if the solver does not cover the position
+ */
+double EndgameSolver::turnValue(const GameState &state)
+{
+    check(state);
+    int size = static_cast<int>(state.deck.size());
+    if (size == 0)
+    {
+        return margin(state);
+    }
+
+    double total = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId bean = static_cast<BeanId>(b);
+        int count = state.deck.remaining(bean);
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // Put a card of the bean on top of the others
+        BeanId cards[NUM_CARDS];
+        int n = 0;
+        for (int other = 0; other < NUM_BEAN_TYPES; ++other)
+        {
+            int k = state.deck.remaining(static_cast<BeanId>(other)) - (other == b ? 1 : 0);
+            std::fill(cards + n, cards + n + k, static_cast<BeanId>(other));
+            n += k;
+        }
+        cards[n++] = bean;
+
+        GameState next = state;
+        next.deck = Deck(cards, static_cast<std::size_t>(n));
+        GameEngine(next).drawCard();
+        total += static_cast<double>(count) / size * settle(next, TurnPhase::BuyField);
+    }
+    return total;
+}
+
+/**
+ * @brief Searches a decision
+ *
+ * @param state The table
+ * @param phase The decision
+ * @return The expected final margin for player 1
+ *
+ * The discard of the last turn ends the search: nothing after it earns a coin.
+ */
+double EndgameSolver::search(const GameState &state, TurnPhase phase)
+{
+    bool last = static_cast<int>(state.deck.size()) <= LAST_TURN_DECK;
+    if (phase == TurnPhase::Over || (last && phase == TurnPhase::Discard))
+    {
+        return margin(state);
+    }
+
+    // The last turn only depends on the current player and the trade area, and is memoized
+    // as the coins still to come so that it is shared whatever the other player holds
+    std::uint64_t key = last ? lastTurnKey(state, static_cast<int>(phase)) : positionKey(state, static_cast<int>(phase));
+    double base = last ? margin(state) : 0;
+    double best = 0;
+    if (probe(key, best))
+    {
+        return base + best;
+    }
+    ++nodes;
+
+    MoveList moves;
+    if (MoveGen::generate(state, phase, moves) > 1 && last)
+    {
+        pruneLastTurn(state, phase, moves);
+    }
+    int n = moves.size();
+    bool maximize = state.currentPlayer == 1;
+    for (int i = 0; i < n; ++i)
+    {
+        double v = after(state, phase, moves[i]);
+        if (i == 0 || (maximize ? v > best : v < best))
+        {
+            best = v;
+        }
+    }
+    store(key, best - base);
+    return best;
+}
+
+/**
+ * @brief Searches a decision after one of its actions
+ *
+ * @param state The table
+ * @param phase The decision
+ * @param action The action
+ * @return The expected final margin for player 1
+ */
+double EndgameSolver::after(const GameState &state, TurnPhase phase, int action)
+{
+    if (phase == TurnPhase::Discard)
+    {
+        return chance(state, action);
+    }
+
+    GameState next = state;
+    GameEngine(next).step(phase, action);
+    return settle(next, phase);
+}
+
+/**
+ * @brief Plays on to the next decision with a choice, or to a discard, and searches it
+ *
+ * @param state The table to play on
+ * @param phase The decision reached
+ * @return The expected final margin for player 1
+ *
+ * A discard is searched even without a choice, since the draws follow it.
+ */
+double EndgameSolver::settle(GameState &state, TurnPhase phase)
+{
+    GameEngine engine(state);
+    MoveList moves;
+    while (phase != TurnPhase::Over && phase != TurnPhase::Discard && MoveGen::generate(state, phase, moves) == 1)
+    {
+        engine.step(phase, moves[0]);
+    }
+    return search(state, phase);
+}
+
+/**
+ * @brief Searches the draws that follow a discard
+ *
+ * @param state The table, at the discard of a turn that is not the last
+ * @param action The discard
+ * @return The expected final margin for player 1
+ *
+ * The end of turn draw only matters if the player has another turn; otherwise it is
+ * skipped, and so is the next turn's card if it lands behind two cards the next player
+ * can plant. Skipped cards are dealt from what the other positions leave.
+ */
+double EndgameSolver::chance(const GameState &state, int action)
+{
+    GameState discarded = state;
+    if (action >= 0)
+    {
+        GameEngine(discarded).discard(action);
+    }
+    if (static_cast<int>(discarded.deck.size()) <= LAST_TURN_DECK)
+    {
+        return margin(discarded);
+    }
+
+    // A player without another turn only keeps their coins, so their hand and fields are left
+    // out and the value is memoized relative to the margin, as in the last turn
+    std::uint64_t key = positionKey(discarded, CHANCE);
+    bool playsAgain = static_cast<int>(discarded.deck.size()) - NUM_DRAWS > LAST_TURN_DECK;
+    double base = 0;
+    if (!playsAgain)
+    {
+        key ^= discarded.playerHash(discarded.currentPlayer);
+        base = margin(discarded);
+    }
+    double value;
+    if (probe(key, value))
+    {
+        return base + value;
+    }
+    ++nodes;
+
+    Draws draws;
+    draws.left = static_cast<int>(discarded.deck.size());
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        draws.counts[b] = discarded.deck.remaining(static_cast<BeanId>(b));
+    }
+    const Hand &nextHand = discarded.players[2 - discarded.currentPlayer].getHand();
+    for (int i = 0; i < NUM_DRAWS; ++i)
+    {
+        bool endOfTurn = i >= GameEngine::TRADE_AREA_DRAW && i < NUM_DRAWS - 1;
+        bool nextTurn = i == NUM_DRAWS - 1;
+        draws.skipped[i] = !playsAgain && (endOfTurn || (nextTurn && static_cast<int>(nextHand.size()) >= PLANTINGS));
+    }
+    draws.probability = 1;
+
+    value = deal(discarded, draws, 0);
+    store(key, value - base);
+    return value;
+}
+
+/**
+ * @brief Deals each bean at one draw position in turn and searches the outcomes
+ *
+ * @param discarded The table after the discard
+ * @param draws The beans dealt at the earlier positions
+ * @param position The position to deal
+ * @return The expected final margin for player 1, weighted by the chance of the earlier beans
+ *
+ * The trade area is a multiset, so its beans are dealt in ascending order and each
+ * multiset is weighted by its number of orders.
+ */
+double EndgameSolver::deal(const GameState &discarded, Draws &draws, int position)
+{
+    if (position == NUM_DRAWS)
+    {
+        // Stack the deck: the rest at the bottom, a skipped position takes a card of the rest
+        BeanId cards[NUM_CARDS];
+        int n = 0;
+        for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+        {
+            std::fill(cards + n, cards + n + draws.counts[b], static_cast<BeanId>(b));
+            n += draws.counts[b];
+        }
+        BeanId order[NUM_DRAWS];
+        for (int i = 0; i < NUM_DRAWS; ++i)
+        {
+            order[i] = draws.skipped[i] ? cards[--n] : draws.beans[i];
+        }
+        for (int i = NUM_DRAWS - 1; i >= 0; --i)
+        {
+            cards[n++] = order[i];
+        }
+
+        GameState next = discarded;
+        next.deck = Deck(cards, static_cast<std::size_t>(n));
+        TurnPhase phase = TurnPhase::Discard;
+        GameEngine(next).step(phase, -1);
+
+        const BeanId *fill = draws.beans;
+        int distinct = 1 + (fill[1] != fill[0]) + (fill[2] != fill[1]);
+        double orders = distinct == 3 ? 6 : distinct == 2 ? 3 : 1;
+        return orders * draws.probability * settle(next, phase);
+    }
+
+    if (draws.skipped[position])
+    {
+        return deal(discarded, draws, position + 1);
+    }
+
+    bool ascending = position > 0 && position < GameEngine::TRADE_AREA_DRAW;
+    int first = ascending ? static_cast<int>(draws.beans[position - 1]) : 0;
+    double probability = draws.probability;
+    double total = 0;
+    for (int b = first; b < NUM_BEAN_TYPES; ++b)
+    {
+        if (draws.counts[b] == 0)
+        {
+            continue;
+        }
+        draws.beans[position] = static_cast<BeanId>(b);
+        draws.probability = probability * draws.counts[b] / draws.left;
+        --draws.counts[b];
+        --draws.left;
+        total += deal(discarded, draws, position + 1);
+        ++draws.counts[b];
+        ++draws.left;
+    }
+    draws.probability = probability;
+    return total;
+}
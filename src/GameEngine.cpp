@@ -0,0 +1,451 @@
+#include "GameEngine.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include "Agent.h"
+#include "MoveGen.h"
+
+/**
+ * @brief Replaces the deck and deals the initial hands
+ *
+ * @param deck The shuffled deck to play with
+ * @return true if every player received INITIAL_HAND_SIZE cards
+ */
+bool GameEngine::deal(const Deck &deck)
+{
+    if (journal)
+    {
+        journal->clear();
+    }
+
+    state.deck = deck;
+    bool dealt = true;
+    for (Player &player : state.players)
+    {
+        if (player.drawToHand(state.deck, INITIAL_HAND_SIZE) < INITIAL_HAND_SIZE)
+        {
+            dealt = false;
+            break;
+        }
+    }
+
+    for (CardTracker *tracker : trackers)
+    {
+        if (tracker)
+        {
+            tracker->reset(state);
+        }
+    }
+    return dealt;
+}
+
+/**
+ * @brief Draws cards from the deck into the back of the current player's hand
+ *
+ * @param n Number of cards to draw
+ * @return Number of cards drawn (fewer than n if the deck runs out)
+ *
+ * The cards are drawn in one Deck::drawN(), then journaled from the back of the hand,
+ * where they now are in draw order.
+ */
+int GameEngine::drawToHand(int n)
+{
+    beginMove();
+    Player &player = currentPlayer();
+    int drawn = player.drawToHand(state.deck, n);
+    if (logging())
+    {
+        const Hand &hand = player.getHand();
+        for (int i = static_cast<int>(hand.size()) - drawn; i < static_cast<int>(hand.size()); ++i)
+        {
+            log(Journal::Op::DrawToHand, hand.beanAt(i));
+        }
+    }
+    return drawn;
+}
+
+/**
+ * @brief Draws the card that starts the turn into the current player's hand
+ *
+ * @return The drawn card, nullptr if the deck is empty
+ */
+const Card *GameEngine::drawCard()
+{
+    if (state.deck.empty())
+    {
+        return nullptr;
+    }
+
+    note(GameLog::Event::Draw);
+    drawToHand(1);
+    return currentPlayer().getHand().peek(static_cast<int>(currentPlayer().getHand().size()) - 1);
+}
+
+/**
+ * @brief Checks if the current player may buy a third field
+ *
+ * @return true if they have two fields and at least THIRD_CHAIN_COST coins
+ */
+bool GameEngine::canBuyThirdChain() const
+{
+    return MoveGen::canBuyField(currentPlayer());
+}
+
+/**
+ * @brief Buys a third field for the current player
+ *
+ * @throws NotEnoughCoins if the player cannot afford it
+ * @throws std::runtime_error if the player already has three fields
+ */
+void GameEngine::buyThirdChain()
+{
+    currentPlayer().buyThirdChain();
+    beginMove();
+    log(Journal::Op::BuyField);
+    note(GameLog::Event::BuyField);
+}
+
+/**
+ * @brief Sells the current player's chain in a field
+ *
+ * @param chainIndex The field, which must be planted
+ * @return Number of coins earned
+ */
+int GameEngine::harvestField(int chainIndex)
+{
+    const Chain_Base &chain = currentPlayer()[chainIndex];
+    log(Journal::Op::Harvest, chain.getBeanId(), chainIndex, chain.size());
+    return currentPlayer().harvestChain(chain.getBeanId());
+}
+
+/**
+ * @brief Adds a card to the current player's chains
+ *
+ * @param card The card, which must be chainable
+ * @return The chain the card was added to
+ *
+ * A chain that can no longer earn another coin is harvested first, as
+ * Player::addCardToChain() would, so that the harvest is journaled too.
+ */
+const Chain_Base &GameEngine::addToChain(const Card *card)
+{
+    Player &player = currentPlayer();
+    BeanId bean = card->getId();
+
+    int chainIndex = player.getChainIndex(bean);
+    if (chainIndex >= 0 && Beanometer::cardsToNextCoin(bean, player[chainIndex].size()) == 0)
+    {
+        harvestField(chainIndex);
+    }
+
+    const Chain_Base &chain = player.addCardToChain(card);
+    log(Journal::Op::AddToChain, bean, player.getChainIndex(bean));
+    return chain;
+}
+
+/**
+ * @brief Moves one card from the trade area into the current player's chains
+ *
+ * @param bean Bean type of the card to take
+ * @return The chain the card was added to
+ * @throws std::runtime_error if the trade area has no such card or no field can take it
+ *
+ * Both conditions are checked before the card leaves the trade area, so a failed
+ * attempt never loses the card.
+ */
+const Chain_Base &GameEngine::chainFromTradeArea(BeanId bean)
+{
+    TradeArea &tradeArea = state.tradeArea;
+    if (!tradeArea.contains(bean))
+    {
+        throw std::runtime_error("No matching bean card found in trade area");
+    }
+
+    Player &player = currentPlayer();
+    if (!player.canChain(bean))
+    {
+        throw std::runtime_error("No available chain slots");
+    }
+
+    beginMove();
+    note(GameLog::Event::TakeTrade, static_cast<int>(bean));
+    const Card *card = tradeArea.trade(bean);
+    log(Journal::Op::TakeFromTrade, bean);
+    return addToChain(card);
+}
+
+/**
+ * @brief Plants the front card of the current player's hand
+ *
+ * @return The card planted and whether a field could take it
+ * @throws std::runtime_error if the hand is empty
+ *
+ * A card that cannot be chained is put back at the front of the hand.
+ */
+Planting GameEngine::plantFromHand()
+{
+    Player &player = currentPlayer();
+    Planting planting;
+    planting.card = player.playFromHand();
+    beginMove();
+    note(GameLog::Event::Plant);
+    log(Journal::Op::PlayFromHand, planting.card->getId());
+
+    if (player.canChain(planting.card->getId()))
+    {
+        addToChain(planting.card);
+        planting.chained = true;
+    }
+    else
+    {
+        player.addToFrontOfHand(planting.card);
+        log(Journal::Op::AddToFront, planting.card->getId());
+    }
+    return planting;
+}
+
+/**
+ * @brief Harvests one of the current player's chains
+ *
+ * @param chainIndex Index of the chain
+ * @return Number of coins earned, 0 if the field is unplanted
+ * @throws std::out_of_range if chainIndex is invalid
+ */
+int GameEngine::harvest(int chainIndex)
+{
+    if (currentPlayer()[chainIndex].empty())
+    {
+        return 0;
+    }
+    beginMove();
+    note(GameLog::Event::Harvest, chainIndex);
+    return harvestField(chainIndex);
+}
+
+/**
+ * @brief Moves a card from the current player's hand onto the discard pile
+ *
+ * @param handIndex Index of the card in the hand
+ * @return The discarded card
+ * @throws std::out_of_range if handIndex is invalid
+ */
+const Card *GameEngine::discard(int handIndex)
+{
+    const Card *card = currentPlayer().getCardFromHand(handIndex);
+    beginMove();
+    note(GameLog::Event::Discard, handIndex);
+    log(Journal::Op::RemoveFromHand, card->getId(), handIndex);
+    state.discardPile += card;
+    log(Journal::Op::Discard, card->getId());
+    return card;
+}
+
+/**
+ * @brief Turns the top cards of the deck into the trade area
+ *
+ * @return Number of cards drawn (fewer than TRADE_AREA_DRAW if the deck runs out)
+ *
+ * The trade area keeps no order, so the cards to journal are read off the top of the
+ * deck before Deck::drawN() turns them.
+ */
+std::size_t GameEngine::fillTradeArea()
+{
+    beginMove();
+    note(GameLog::Event::FillTrade);
+    std::array<BeanId, TRADE_AREA_DRAW> turned;
+    std::size_t count = std::min<std::size_t>(TRADE_AREA_DRAW, state.deck.size());
+    bool logged = logging();
+    for (std::size_t k = 0; logged && k < count; ++k)
+    {
+        turned[k] = state.deck.peek(k)->getId();
+    }
+
+    std::size_t drawn = state.deck.drawN(TRADE_AREA_DRAW, state.tradeArea);
+    for (std::size_t k = 0; logged && k < drawn; ++k)
+    {
+        log(Journal::Op::DeckToTrade, turned[k]);
+    }
+    return drawn;
+}
+
+/**
+ * @brief Moves matching cards from the top of the discard pile into the trade area
+ *
+ * @return Number of cards moved
+ *
+ * Stops at the first card that is not legal in the trade area (see TradeArea::drain()).
+ */
+std::size_t GameEngine::drainDiscardPile()
+{
+    beginMove();
+    note(GameLog::Event::Drain);
+    return state.tradeArea.drain(state.discardPile,
+                                 [this](const Card *card) { log(Journal::Op::DiscardToTrade, card->getId()); });
+}
+
+/**
+ * @brief Passes the turn to the next player
+ */
+void GameEngine::endTurn()
+{
+    beginMove();
+    log(Journal::Op::NextPlayer);
+    note(GameLog::Event::EndTurn);
+    state.nextPlayer();
+}
+
+/**
+ * @brief Plays a whole turn of the current player, asking the agent for every decision
+ *
+ * @param agent The agent of the current player
+ *
+ * Runs the same phases as the terminal game, without output: draw, third field,
+ * trade area, one or two plantings, harvest, discard, trade area fill, discard pile
+ * drain, end of turn draw. A move the rules reject is skipped rather than ending the game.
+ */
+void GameEngine::playTurn(Agent &agent)
+{
+    drawCard();
+
+    if (canBuyThirdChain() && agent.buyThirdChain(*this))
+    {
+        buyThirdChain();
+    }
+
+    BeanId bean;
+    while (!state.tradeArea.empty() && agent.chooseTradeBean(*this, bean))
+    {
+        if (!(MoveGen::tradeMoves(state) & beanBit(bean)))
+        {
+            break;
+        }
+        chainFromTradeArea(bean);
+    }
+
+    if (!currentPlayer().isHandEmpty())
+    {
+        plantFromHand();
+        if (!currentPlayer().isHandEmpty() && agent.playSecondCard(*this))
+        {
+            plantFromHand();
+        }
+    }
+
+    int chainIndex = agent.chooseChainToHarvest(*this);
+    if (chainIndex >= 0 && chainIndex < currentPlayer().getMaxNumChains())
+    {
+        harvest(chainIndex);
+    }
+
+    int handIndex = agent.chooseCardToDiscard(*this);
+    if (handIndex >= 0 && handIndex < MoveGen::discardMoves(currentPlayer()))
+    {
+        discard(handIndex);
+    }
+
+    fillTradeArea();
+    drainDiscardPile();
+    drawEndOfTurn();
+    endTurn();
+}
+
+/**
+ * @brief Carries out one decision and plays on to the next decision that offers a choice
+ *
+ * @param phase The decision being made; set to the next one, TurnPhase::Over at the end
+ * @param action One of the actions MoveGen::generate() lists for the decision
+ */
+void GameEngine::act(TurnPhase &phase, int action)
+{
+    step(phase, action);
+    settle(phase);
+}
+
+/**
+ * @brief Plays through every decision that offers a single action
+ *
+ * @param phase The decision reached; set to the next one with a choice
+ */
+void GameEngine::settle(TurnPhase &phase)
+{
+    MoveList moves;
+    while (phase != TurnPhase::Over && MoveGen::generate(state, phase, moves) == 1)
+    {
+        step(phase, moves[0]);
+    }
+}
+
+/**
+ * @brief Carries out one decision and the steps up to the next decision
+ *
+ * @param phase The decision being made; set to the next one, TurnPhase::Over at the end
+ * @param action One of the actions MoveGen::generate() lists for the decision
+ *
+ * The first planting follows the last trade area card taken; the discard ends the
+ * turn and draws the card that starts the next one.
+ */
+void GameEngine::step(TurnPhase &phase, int action)
+{
+    switch (phase)
+    {
+    case TurnPhase::BuyField:
+        if (action != 0)
+        {
+            buyThirdChain();
+        }
+        phase = TurnPhase::TakeTrade;
+        break;
+
+    case TurnPhase::TakeTrade:
+        if (action >= 0)
+        {
+            chainFromTradeArea(static_cast<BeanId>(action));
+            break;
+        }
+        if (!currentPlayer().isHandEmpty())
+        {
+            plantFromHand();
+        }
+        phase = TurnPhase::PlantSecond;
+        break;
+
+    case TurnPhase::PlantSecond:
+        if (action != 0)
+        {
+            plantFromHand();
+        }
+        phase = TurnPhase::Harvest;
+        break;
+
+    case TurnPhase::Harvest:
+        if (action >= 0)
+        {
+            harvest(action);
+        }
+        phase = TurnPhase::Discard;
+        break;
+
+    case TurnPhase::Discard:
+        if (action >= 0)
+        {
+            discard(action);
+        }
+        fillTradeArea();
+        drainDiscardPile();
+        drawEndOfTurn();
+        endTurn();
+        if (isOver())
+        {
+            phase = TurnPhase::Over;
+        }
+        else
+        {
+            drawCard();
+            phase = TurnPhase::BuyField;
+        }
+        break;
+
+    case TurnPhase::Over:
+        break;
+    }
+}
@@ -0,0 +1,210 @@
+#include "GameLog.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "BinaryIO.h"
+#include "GameEngine.h"
+#include "Table.h"
+
+constexpr std::uint8_t GameLog::MAGIC[4];
+constexpr std::size_t GameLog::HEADER_SIZE;
+
+/**
+ * @brief Starts a log by writing its header
+ *
+ * @param out Stream the log is appended to
+ * @param start The position the game goes on from
+ * @throws std::length_error if the position's save does not fit in the header
+ */
+GameLog::GameLog(std::ostream &out, const Table &start)
+    : out(out)
+{
+    std::vector<std::uint8_t> header;
+    header.reserve(HEADER_SIZE + 128);
+    ByteWriter writer(header);
+    writer.bytes(reinterpret_cast<const char *>(MAGIC), sizeof(MAGIC));
+    writer.byte(VERSION);
+    writer.byte(0);
+    writer.byte(0);
+    start.saveBinary(header);
+
+    std::size_t startSize = header.size() - HEADER_SIZE;
+    writer.patch(HEADER_SIZE - 2, static_cast<int>(startSize & 0xFF));
+    writer.patch(HEADER_SIZE - 1, static_cast<int>(startSize >> 8));
+
+    out.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+    out.flush();
+}
+
+/**
+ * @brief Appends an event
+ *
+ * @param event The kind of step
+ * @param arg Its argument: a bean, a field or, for a discard, the hand index
+ */
+void GameLog::append(Event event, int arg)
+{
+    int kind = static_cast<int>(event);
+    if (event == Event::Discard)
+    {
+        out.put(static_cast<char>(kind << 4));
+        out.put(static_cast<char>(arg));
+    }
+    else
+    {
+        out.put(static_cast<char>(kind << 4 | (arg & 0xF)));
+    }
+    ++events;
+
+    if (event == Event::EndTurn)
+    {
+        out.flush();
+    }
+}
+
+/**
+ * @brief Reads a log
+ *
+ * @param data First byte of the log
+ * @param size Number of bytes
+ * @throws std::runtime_error if the data is not a valid log
+ *
+ * Checks the header and the starting position, then walks the events once to check
+ * their framing and to find where each turn ends.
+ */
+GameReplay::GameReplay(const std::uint8_t *data, std::size_t size)
+{
+    if (size < GameLog::HEADER_SIZE ||
+        !std::equal(GameLog::MAGIC, GameLog::MAGIC + sizeof(GameLog::MAGIC), data))
+    {
+        throw std::runtime_error("Not a game log");
+    }
+
+    ByteReader in(data + sizeof(GameLog::MAGIC), size - sizeof(GameLog::MAGIC));
+    int version = in.byte();
+    if (version != GameLog::VERSION)
+    {
+        throw std::runtime_error("Unsupported game log version: " + std::to_string(version));
+    }
+    startSize = static_cast<std::size_t>(in.byte());
+    startSize |= static_cast<std::size_t>(in.byte()) << 8;
+    start = in.bytes(startSize);
+    if (!Table::isBinary(start, startSize))
+    {
+        throw std::runtime_error("Game log does not start with a binary save");
+    }
+    Table check(start, startSize);
+
+    first = start + startSize;
+    end = data + size;
+    for (const std::uint8_t *event = first; event != end; ++event)
+    {
+        int kind = *event >> 4;
+        if (kind >= GameLog::NUM_EVENTS)
+        {
+            throw std::runtime_error("Unknown event in game log: " + std::to_string(kind));
+        }
+        if (static_cast<GameLog::Event>(kind) == GameLog::Event::Discard && ++event == end)
+        {
+            throw std::runtime_error("Game log is truncated");
+        }
+        if (static_cast<GameLog::Event>(kind) == GameLog::Event::EndTurn)
+        {
+            turnEnds.push_back(static_cast<std::size_t>(event + 1 - first));
+        }
+        ++events;
+    }
+}
+
+/**
+ * @brief Rebuilds the position after a number of turns
+ *
+ * @param turn Number of turns to play, from 0 to getTurns()
+ * @return The table
+ * @throws std::out_of_range if turn is out of range
+ * @throws std::runtime_error if an event breaks the rules
+ */
+Table GameReplay::at(int turn) const
+{
+    if (turn < 0 || turn > getTurns())
+    {
+        throw std::out_of_range("Turn " + std::to_string(turn) + " is not in the game log (0 to " +
+                                std::to_string(getTurns()) + ")");
+    }
+    return replay(turn == 0 ? 0 : turnEnds[turn - 1]);
+}
+
+/**
+ * @brief Rebuilds the last position
+ *
+ * @return The table
+ * @throws std::runtime_error if an event breaks the rules
+ */
+Table GameReplay::last() const
+{
+    return replay(static_cast<std::size_t>(end - first));
+}
+
+/**
+ * @brief Replays the events in a byte range onto the starting position
+ *
+ * @param length Number of event bytes to replay, which must end on an event
+ * @return The table
+ * @throws std::runtime_error if an event breaks the rules
+ *
+ * Each event calls the engine step it recorded. The rule checks of the steps catch a
+ * log that does not fit its starting position, e.g. a discard from a hand index that
+ * does not exist.
+ */
+Table GameReplay::replay(std::size_t length) const
+{
+    Table table(start, startSize);
+    GameEngine engine(table);
+
+    for (const std::uint8_t *event = first; event != first + length; ++event)
+    {
+        int arg = *event & 0xF;
+        switch (static_cast<GameLog::Event>(*event >> 4))
+        {
+        case GameLog::Event::Draw:
+            engine.drawCard();
+            break;
+        case GameLog::Event::BuyField:
+            engine.buyThirdChain();
+            break;
+        case GameLog::Event::TakeTrade:
+            if (arg >= NUM_BEAN_TYPES)
+            {
+                throw std::runtime_error("Unknown bean in game log: " + std::to_string(arg));
+            }
+            engine.chainFromTradeArea(static_cast<BeanId>(arg));
+            break;
+        case GameLog::Event::Plant:
+            engine.plantFromHand();
+            break;
+        case GameLog::Event::Harvest:
+            if (arg >= engine.currentPlayer().getMaxNumChains() || engine.currentPlayer()[arg].empty())
+            {
+                throw std::runtime_error("Harvest of an unplanted field in game log: " + std::to_string(arg));
+            }
+            engine.harvest(arg);
+            break;
+        case GameLog::Event::Discard:
+            engine.discard(*++event);
+            break;
+        case GameLog::Event::FillTrade:
+            engine.fillTradeArea();
+            break;
+        case GameLog::Event::Drain:
+            engine.drainDiscardPile();
+            break;
+        case GameLog::Event::DrawEndOfTurn:
+            engine.drawEndOfTurn();
+            break;
+        case GameLog::Event::EndTurn:
+            engine.endTurn();
+            break;
+        }
+    }
+    return table;
+}
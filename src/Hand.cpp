@@ -1,91 +1,219 @@
 #include "Hand.h"
 #include <stdexcept>
+#include "BinaryIO.h"
 #include "CardFactory.h"
+#include "TextReader.h"
 #include <sstream>
 
+namespace
+{
+/**
+ * @brief Multiplier of the hand's polynomial hash; odd, so that it has an inverse modulo 2^64
+ */
+constexpr std::uint64_t MULTIPLIER = GameRng::GOLDEN;
+
+/**
+ * @brief Powers of MULTIPLIER for every position of a hand
+ */
+struct Powers
+{
+    std::uint64_t p[Hand::CAPACITY + 1];
+};
+
+/**
+ * @brief Builds the powers of MULTIPLIER at compile time
+ */
+constexpr Powers buildPowers()
+{
+    Powers table{};
+    table.p[0] = 1;
+    for (int i = 1; i <= Hand::CAPACITY; ++i)
+    {
+        table.p[i] = table.p[i - 1] * MULTIPLIER;
+    }
+    return table;
+}
+
+/**
+ * @brief Inverse of MULTIPLIER modulo 2^64, by Newton's iteration
+ *
+ * An odd number is its own inverse modulo 8; each step doubles the number of correct bits.
+ */
+constexpr std::uint64_t buildInverse()
+{
+    std::uint64_t inverse = MULTIPLIER;
+    for (int bits = 3; bits < 64; bits *= 2)
+    {
+        inverse *= 2 - MULTIPLIER * inverse;
+    }
+    return inverse;
+}
+
+constexpr Powers POWERS = buildPowers();
+constexpr std::uint64_t INVERSE = buildInverse();
+static_assert(MULTIPLIER * INVERSE == 1, "The hash multiplier must be invertible");
+
+/**
+ * @brief Key of a bean in the hand's hash; apart from the positional keys, which stop below CAPACITY
+ */
+std::uint64_t beanKey(BeanId bean)
+{
+    return zobrist::key(zobrist::Part::Hand, Hand::CAPACITY, bean);
+}
+}
+
 /**
  * @brief Constructs a Hand from a saved game state
  *
  * @param in Input stream containing serialized hand data
  * @param factory Pointer to the CardFactory used to create cards
+ * @throws std::runtime_error if a card name is unknown or the input ends before END_HAND
  *
  * Reads card names from the input stream until "END_HAND" is encountered.
  * Each card is recreated using the provided CardFactory.
  */
 Hand::Hand(std::istream &in, const CardFactory *factory)
 {
-    cards.clear();
     std::string cardName;
+    bool ended = false;
 
     while (std::getline(in, cardName))
     {
         if (cardName == "END_HAND")
         {
+            ended = true;
             break;
         }
 
         try
         {
             // Create card from saved name using factory
-            auto card = factory->getFactory()->createCard(cardName);
-            if (card)
-            {
-                *this += std::move(card);
-            }
+            *this += factory->createCard(cardName);
         }
-        catch (const std::exception &e)
+        catch (const std::runtime_error &e)
         {
-            std::cerr << "Error loading hand card: " << e.what() << std::endl;
+            throw std::runtime_error(std::string("Error loading hand: ") + e.what());
         }
     }
+
+    if (!ended)
+    {
+        throw std::runtime_error("Invalid hand format: missing END_HAND");
+    }
+}
+
+/**
+ * @brief Constructs a Hand from a binary save
+ *
+ * @param in Reader positioned at the hand
+ * @throws std::runtime_error if the data is malformed
+ */
+Hand::Hand(ByteReader &in)
+{
+    int size = in.byte();
+    if (size > CAPACITY)
+    {
+        throw std::runtime_error("Hand too large in binary save: " + std::to_string(size));
+    }
+
+    BeanId beans[CAPACITY];
+    in.beans(beans, size);
+    for (int i = 0; i < size; ++i)
+    {
+        *this += Card::get(beans[i]);
+    }
+}
+
+/**
+ * @brief Constructs a Hand by parsing a text save in place
+ *
+ * @param in Reader positioned at the hand
+ * @throws std::runtime_error if a card is unknown or the END_HAND marker is missing
+ */
+Hand::Hand(TextReader &in)
+{
+    for (TextSpan line = in.line(); line != "END_HAND"; line = in.line())
+    {
+        *this += Card::get(TextReader::bean(line));
+    }
 }
 
 /**
  * @brief Adds a card to the back of the hand
  *
- * @param card Unique pointer to the card being added
+ * @param card Pointer to the card being added
  * @return Reference to the modified Hand
  * @throws std::invalid_argument if card pointer is null
+ * @throws std::length_error if the hand is full
  */
-Hand &Hand::operator+=(std::unique_ptr<Card> card)
+Hand &Hand::operator+=(const Card *card)
 {
     if (!card)
     {
         throw std::invalid_argument("Cannot add null card to hand");
     }
+    checkCapacity();
 
-    // Add card to back of list (rear of hand)
-    cards.push_back(std::move(card));
+    // Add card to back of buffer (rear of hand); every card already in it moves up a power
+    cards[slot(count)] = card->getId();
+    hashValue = hashValue * MULTIPLIER + beanKey(card->getId());
+    ++count;
     return *this;
 }
 
 /**
  * @brief Plays and removes the first card from the hand
  *
- * @return Unique pointer to the played card
+ * @return Pointer to the played card
  * @throws std::runtime_error if the hand is empty
  */
-std::unique_ptr<Card> Hand::play()
+const Card *Hand::play()
 {
-    if (cards.empty())
+    if (count == 0)
     {
         throw std::runtime_error("Cannot play from empty hand");
     }
 
     // Remove and return first card (front of hand)
-    std::unique_ptr<Card> topCard = std::move(cards.front());
-    cards.pop_front();
-    return topCard;
+    BeanId topCard = cards[head];
+    hashValue -= beanKey(topCard) * POWERS.p[count - 1];
+    head = static_cast<std::uint8_t>(slot(1));
+    --count;
+    return Card::get(topCard);
 }
 
 /**
  * @brief Adds a card to the front of the hand
  *
- * @param card Unique pointer to the card being added
+ * @param card Pointer to the card being added
+ * @throws std::invalid_argument if card pointer is null
+ * @throws std::length_error if the hand is full
  */
-void Hand::addToFront(std::unique_ptr<Card> card)
+void Hand::addToFront(const Card *card)
 {
-    cards.push_front(std::move(card));
+    if (!card)
+    {
+        throw std::invalid_argument("Cannot add null card to hand");
+    }
+    checkCapacity();
+
+    head = static_cast<std::uint8_t>(slot(CAPACITY - 1));
+    cards[head] = card->getId();
+    hashValue += beanKey(card->getId()) * POWERS.p[count];
+    ++count;
+}
+
+/**
+ * @brief Throws if the ring buffer has no free slot
+ *
+ * @throws std::length_error if the hand already holds CAPACITY cards
+ */
+void Hand::checkCapacity() const
+{
+    if (count >= CAPACITY)
+    {
+        throw std::length_error("Cannot add card to full hand");
+    }
 }
 
 /**
@@ -96,12 +224,12 @@ void Hand::addToFront(std::unique_ptr<Card> card)
  */
 const Card *Hand::top() const
 {
-    if (cards.empty())
+    if (count == 0)
     {
         throw std::runtime_error("Cannot get top card from empty hand");
     }
 
-    return cards.front().get();
+    return Card::get(cards[head]);
 }
 
 /**
@@ -112,10 +240,10 @@ const Card *Hand::top() const
  */
 void Hand::validateIndex(int index) const
 {
-    if (index < 0 || index >= static_cast<int>(cards.size()))
+    if (index < 0 || index >= count)
     {
         std::ostringstream oss;
-        oss << "Index " << index << " is out of range. Hand size is " << cards.size();
+        oss << "Index " << index << " is out of range. Hand size is " << static_cast<int>(count);
         throw std::out_of_range(oss.str());
     }
 }
@@ -124,20 +252,118 @@ void Hand::validateIndex(int index) const
  * @brief Removes and returns the card at the specified index
  *
  * @param index Position of the card to remove (0-based)
- * @return Unique pointer to the removed card
+ * @return Pointer to the removed card
  * @throws std::out_of_range if index is invalid
  */
-std::unique_ptr<Card> Hand::operator[](int index)
+const Card *Hand::operator[](int index)
 {
     validateIndex(index);
 
-    // Find the card at the specified index
-    auto it = std::next(cards.begin(), index);
+    BeanId card = cards[slot(index)];
+    hashValue -= beanKey(card) * POWERS.p[count - 1 - index];
 
-    // Move ownership of the card and remove it from the list
-    std::unique_ptr<Card> card = std::move(*it);
-    cards.erase(it);
-    return card;
+    // Close the gap by shifting whichever side of the hand is shorter. Cards in front of
+    // the gap lose a card behind them, so their weight drops a power.
+    if (index < count / 2)
+    {
+        std::uint64_t front = weight(0, index);
+        hashValue += front * INVERSE - front;
+        for (int i = index; i > 0; --i)
+        {
+            cards[slot(i)] = cards[slot(i - 1)];
+        }
+        head = static_cast<std::uint8_t>(slot(1));
+    }
+    else
+    {
+        std::uint64_t back = weight(index + 1, count);
+        hashValue = (hashValue - back) * INVERSE + back;
+        for (int i = index; i < count - 1; ++i)
+        {
+            cards[slot(i)] = cards[slot(i + 1)];
+        }
+    }
+    --count;
+    return Card::get(card);
+}
+
+/**
+ * @brief Inserts a card at the specified index
+ *
+ * @param index Position the card will have (0 to size())
+ * @param card Pointer to the card being inserted
+ * @throws std::invalid_argument if card pointer is null
+ * @throws std::out_of_range if index is greater than size()
+ * @throws std::length_error if the hand is full
+ *
+ * Opens the gap on the same side operator[] closes it, so inserting a card
+ * where it was removed from restores the hand exactly.
+ */
+void Hand::insert(int index, const Card *card)
+{
+    if (!card)
+    {
+        throw std::invalid_argument("Cannot add null card to hand");
+    }
+    if (index != count)
+    {
+        validateIndex(index);
+    }
+    checkCapacity();
+
+    // Cards in front of the new one gain a card behind them, so their weight rises a power
+    if (index < (count + 1) / 2)
+    {
+        std::uint64_t front = weight(0, index);
+        hashValue += front * MULTIPLIER - front;
+        head = static_cast<std::uint8_t>(slot(CAPACITY - 1));
+        for (int i = 0; i < index; ++i)
+        {
+            cards[slot(i)] = cards[slot(i + 1)];
+        }
+    }
+    else
+    {
+        std::uint64_t back = weight(index, count);
+        hashValue = (hashValue - back) * MULTIPLIER + back;
+        for (int i = count; i > index; --i)
+        {
+            cards[slot(i)] = cards[slot(i - 1)];
+        }
+    }
+    hashValue += beanKey(card->getId()) * POWERS.p[count - index];
+    cards[slot(index)] = card->getId();
+    ++count;
+}
+
+/**
+ * @brief Sums what a run of cards adds to the hash
+ *
+ * @param first Position of the first card
+ * @param last Position one past the last card
+ * @return Sum of each card's key times MULTIPLIER to the number of cards behind it
+ */
+std::uint64_t Hand::weight(int first, int last) const
+{
+    std::uint64_t sum = 0;
+    for (int i = first; i < last; ++i)
+    {
+        sum += beanKey(cards[slot(i)]) * POWERS.p[count - 1 - i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Returns the card at the specified index without removing it
+ *
+ * @param index Position of the card (0-based)
+ * @return Pointer to the card
+ * @throws std::out_of_range if index is invalid
+ */
+const Card *Hand::peek(int index) const
+{
+    validateIndex(index);
+    return Card::get(cards[slot(index)]);
 }
 
 /**
@@ -152,9 +378,9 @@ std::unique_ptr<Card> Hand::operator[](int index)
 std::ostream &operator<<(std::ostream &out, const Hand &hand)
 {
     out << "Hand: ";
-    for (const auto &card : hand.cards)
+    for (int i = 0; i < hand.count; ++i)
     {
-        card->print(out);
+        Card::get(hand.beanAt(i))->print(out);
         out << " ";
     }
     return out;
@@ -170,12 +396,25 @@ std::ostream &operator<<(std::ostream &out, const Hand &hand)
  */
 void Hand::serialize(std::ostream &out) const
 {
-    for (const auto &card : cards)
+    for (int i = 0; i < count; ++i)
     {
-        if (card)
-        {
-            out << card->getName() << "\n";
-        }
+        out << Card::get(beanAt(i))->getName() << "\n";
     }
     out << "END_HAND\n";
+}
+
+/**
+ * @brief Writes the hand to a binary save
+ *
+ * @param out Writer to append to
+ */
+void Hand::writeBinary(ByteWriter &out) const
+{
+    BeanId beans[CAPACITY];
+    for (int i = 0; i < count; ++i)
+    {
+        beans[i] = beanAt(i);
+    }
+    out.byte(count);
+    out.beans(beans, count);
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "Journal.h"
+#include "GameEngine.h"
+#include "GameState.h"
+
+namespace
+{
+/**
+ * @brief Takes the card at the back of a hand, reversing a draw into it
+ *
+ * @param hand The hand, which must not be empty
+ */
+void takeFromBack(Hand &hand)
+{
+    // Hand::operator[] removes the card as it returns it; the card itself is not needed
+    (void)hand[static_cast<int>(hand.size()) - 1];
+}
+}
+
+/**
+ * @brief Reverses the most recent moves
+ *
+ * @param state The state the moves were made on
+ * @param n Number of moves to reverse
+ * @return Number of moves reversed
+ *
+ * Records are reversed newest first, so each one sees the state exactly as it was
+ * right after the change it describes.
+ */
+int Journal::undo(GameState &state, int n)
+{
+    int undone = 0;
+    while (undone < n && !marks.empty())
+    {
+        std::size_t first = marks.back();
+        while (records.size() > first)
+        {
+            revert(state, records.back());
+            records.pop_back();
+        }
+        marks.pop_back();
+        ++undone;
+    }
+    return undone;
+}
+
+/**
+ * @brief Reverses a single record
+ *
+ * @param state The state to change
+ * @param change The record to reverse
+ */
+void Journal::revert(GameState &state, const Record &change)
+{
+    Player &player = state.players[change.player];
+    const Card *card = Card::get(change.bean);
+
+    switch (change.op)
+    {
+    case Op::DrawToHand:
+        takeFromBack(player.hand);
+        state.deck.addCard(card);
+        break;
+
+    case Op::PlayFromHand:
+        player.hand.addToFront(card);
+        break;
+
+    case Op::AddToFront:
+        player.hand.play();
+        break;
+
+    case Op::RemoveFromHand:
+        player.hand.insert(change.a, card);
+        break;
+
+    case Op::TakeFromTrade:
+        state.tradeArea += card;
+        break;
+
+    case Op::DeckToTrade:
+        state.tradeArea.trade(change.bean);
+        state.deck.addCard(card);
+        break;
+
+    case Op::Discard:
+        state.discardPile.pickUp();
+        break;
+
+    case Op::DiscardToTrade:
+        state.tradeArea.trade(change.bean);
+        state.discardPile += card;
+        break;
+
+    case Op::Harvest:
+        player.setCoins(player.coins - Beanometer::coins(change.bean, change.b));
+        player.setChain(change.a, Chain_Base(change.bean, change.b));
+        player.slotOf[static_cast<int>(change.bean)] = static_cast<std::int8_t>(change.a);
+        break;
+
+    case Op::AddToChain:
+    {
+        int remaining = player.chains[change.a].size() - 1;
+        if (remaining > 0)
+        {
+            player.setChain(change.a, Chain_Base(change.bean, remaining));
+        }
+        else
+        {
+            player.setChain(change.a, Chain_Base());
+            player.slotOf[static_cast<int>(change.bean)] = -1;
+        }
+        break;
+    }
+
+    case Op::BuyField:
+        player.setCoins(player.coins + GameEngine::THIRD_CHAIN_COST);
+        player.setNumFields(2);
+        break;
+
+    case Op::NextPlayer:
+        state.nextPlayer();
+        break;
+    }
+}
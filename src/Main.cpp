@@ -1,38 +1,35 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
-#include <limits>
 #include <stdexcept>
 #include <memory>
+#include <thread>
+#include <vector>
 #include "CardFactory.h"
-#include "Table.h"
+#include "Agent.h"
+#include "CorpusLoader.h"
+#include "EndgameSolver.h"
+#include "GameLog.h"
+#include "MappedFile.h"
+#include "MctsAgent.h"
 
 /**
- * @brief Utility function to get a yes/no input from the user.
- * @param prompt The question to ask the user.
- * @return True if user enters 'y', false if user enters 'n'.
+ * @brief Plants the front card of the current player's hand and reports the result.
+ * @param engine The engine running the game.
  */
-bool getUserChoice(const std::string &prompt) {
-    std::string input;
-    while (true) {
-        std::cout << prompt << " (y/n): ";
-
-        if (!std::getline(std::cin, input)) {
-            std::cin.clear();
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            continue;
+void plantCard(GameEngine &engine) {
+    try {
+        Planting planting = engine.plantFromHand();
+        std::cout << "\nPlayed card: " << planting.card->getName() << "\n";
+        if (planting.chained) {
+            std::cout << "Card chained.\n";
         }
-
-        input.erase(0, input.find_first_not_of(" \t\n\r\f\v"));
-        input.erase(input.find_last_not_of(" \t\n\r\f\v") + 1);
-
-        if (input.length() == 1) {
-            char choice = std::tolower(input[0]);
-            if (choice == 'y') return true;
-            if (choice == 'n') return false;
-        }
-
-        std::cout << "Invalid input. Please enter 'y' or 'n'.\n";
+    } catch (const std::exception &e) {
+        std::cout << "Error: " << e.what() << "\n";
     }
 }
 
@@ -47,19 +44,251 @@ void clearScreen() {
 #endif
 }
 
+/**
+ * @brief Prints the command line syntax.
+ */
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--computer 1|2] [--think ms] [--endgame N] [--record file]\n"
+              << "       " << program << " --analyze file | --replay file [turn] | --load-corpus dir|glob\n"
+              << "  --computer N  the computer plays seat N (may be given twice)\n"
+              << "  --think ms    the computer's thinking time per decision (default 50)\n"
+              << "  --threads N   worker threads for the computer and --load-corpus (default: one per core)\n"
+              << "  --endgame N   solve exactly once the deck has fewer than N cards\n"
+              << "                (default 6 for the computer, 12 for --analyze)\n"
+              << "  --record f    write a log of every step of the game to file f\n"
+              << "  --analyze f   report the endgame of the saved game in file f and exit\n"
+              << "  --replay f N  print the position after N turns of the game logged in file f\n"
+              << "                (default: the last position) and exit\n"
+              << "  --load-corpus d\n"
+              << "                load every save in directory d, or matching glob d, report the\n"
+              << "                throughput and the files that failed, and exit\n";
+}
+
+/**
+ * @brief Loads a saved game in either format.
+ * @param filename The saved game.
+ * @return The table.
+ * @throws std::runtime_error if the file cannot be read or is not a valid save.
+ *
+ * The file is memory-mapped and parsed in place; Table tells the formats apart.
+ */
+std::unique_ptr<Table> loadTable(const std::string &filename) {
+    MappedFile file(filename);
+    return std::make_unique<Table>(file.data(), file.size());
+}
+
+/**
+ * @brief Saves a game, in the binary format if the file name ends in ".bin".
+ * @param table The table.
+ * @param filename The file to save to.
+ * @throws std::runtime_error if the file cannot be opened.
+ */
+void saveTable(const Table &table, const std::string &filename) {
+    const std::string binary = ".bin";
+    bool isBinary = filename.size() >= binary.size() &&
+                    filename.compare(filename.size() - binary.size(), binary.size(), binary) == 0;
+
+    std::ofstream saveFile(filename, isBinary ? std::ios::binary : std::ios::out);
+    if (!saveFile) {
+        throw std::runtime_error("Could not open file for saving: " + filename);
+    }
+    if (isBinary) {
+        table.saveBinary(saveFile);
+    } else {
+        table.saveGame(saveFile);
+    }
+}
+
+/**
+ * @brief Reports the endgame of a saved game.
+ * @param filename The saved game.
+ * @param threshold Deck size the endgame starts below.
+ * @return Exit status code.
+ *
+ * The game is played on from the save by the greedy computer player, with the saved
+ * deck order, until a turn starts with fewer cards than the threshold. The endgame
+ * solver then gives the expected final margin with best play from both sides, and the
+ * greedy player finishes the game for comparison.
+ */
+int analyze(const std::string &filename, int threshold) {
+    std::unique_ptr<Table> table;
+    try {
+        table = loadTable(filename);
+    } catch (const std::exception &e) {
+        std::cerr << "Error loading game: " << e.what() << "\n";
+        return 1;
+    }
+
+    GameState &state = table->getState();
+    GameEngine engine(state);
+    GreedyAgent greedy;
+    EndgameSolver solver(threshold);
+    const std::string &name1 = table->getPlayerName(1);
+    const std::string &name2 = table->getPlayerName(2);
+    auto margin = [&state]() { return state.players[0].getNumCoins() - state.players[1].getNumCoins(); };
+
+    std::cout << filename << ": " << state.deck.size() << " cards in the deck, "
+              << table->getPlayerName(state.currentPlayer) << " to play\n";
+    int turns = 0;
+    for (; !solver.covers(state); ++turns) {
+        engine.playTurn(greedy);
+    }
+    if (turns > 0) {
+        std::cout << "After " << turns << " greedy turns: " << state.deck.size() << " cards in the deck, "
+                  << table->getPlayerName(state.currentPlayer) << " to play\n";
+    }
+    std::cout << "Coins: " << name1 << " " << state.players[0].getNumCoins() << ", " << name2 << " "
+              << state.players[1].getNumCoins() << "\n";
+
+    double expected = solver.turnValue(state);
+    std::cout << std::fixed << std::setprecision(2) << std::showpos
+              << "Best play:   expected final margin " << expected << " for " << name1 << std::noshowpos
+              << " (" << solver.getNodes() << " positions solved)\n";
+
+    while (!engine.isOver()) {
+        engine.playTurn(greedy);
+    }
+    std::cout << std::showpos << "Greedy play: final margin " << margin() << " for " << name1 << std::noshowpos
+              << " with the saved deck order\n";
+    return 0;
+}
+
+/**
+ * @brief Prints a position of a logged game.
+ * @param filename The game log.
+ * @param turn Number of turns to replay, -1 for every step in the log.
+ * @return Exit status code.
+ */
+int replay(const std::string &filename, int turn) {
+    try {
+        MappedFile file(filename);
+        GameReplay log(file.data(), file.size());
+        Table table = turn < 0 ? log.last() : log.at(turn);
+        std::cout << filename << ": " << log.getTurns() << " turns, " << log.getEvents() << " events\n";
+        if (turn >= 0) {
+            std::cout << "After turn " << turn << ":\n";
+        }
+        std::cout << table;
+    } catch (const std::exception &e) {
+        std::cerr << "Error replaying game: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Loads a corpus of saved games and reports the throughput and the failures.
+ * @param where A directory of saves, or a glob pattern.
+ * @param threads Number of worker threads.
+ * @return Exit status code: 1 if any file failed to load.
+ */
+int loadCorpus(const std::string &where, unsigned threads) {
+    std::vector<std::string> paths;
+    try {
+        paths = CorpusLoader::list(where);
+    } catch (const std::exception &e) {
+        std::cerr << "Error listing saves: " << e.what() << "\n";
+        return 1;
+    }
+
+    CorpusLoader loader(threads);
+    CorpusLoader::Report report = loader.load(paths, CorpusLoader::Visitor());
+    for (const CorpusLoader::Error &error : report.errors) {
+        std::cerr << error.path << ": " << error.message << "\n";
+    }
+
+    double seconds = std::max(report.seconds, 1e-9);
+    std::cout << "Loaded " << report.files << " of " << paths.size() << " files (" << report.errors.size()
+              << " failed) with " << loader.getThreads() << " threads in " << std::fixed << std::setprecision(3)
+              << report.seconds << " s\n"
+              << std::setprecision(0) << report.files / seconds << " files/sec, " << report.cards / seconds
+              << " cards/sec, " << std::setprecision(1) << report.bytes / seconds / (1 << 20) << " MiB/sec\n";
+    return report.errors.empty() ? 0 : 1;
+}
+
 /**
  * @brief The main function starts the Bean Trading Card Game.
  *        Allows the user to start a new game or load a saved game, then runs the game loop.
  * @return Exit status code.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    // Seats are played at this terminal unless given to the computer
+    bool computer[2] = {false, false};
+    MctsSettings settings;
+    settings.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string analyzeFile;
+    std::string recordFile;
+    std::string replayFile;
+    std::string corpus;
+    int replayTurn = -1;
+    int endgame = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--computer" && i + 1 < argc) {
+            int seat = std::atoi(argv[++i]);
+            if (seat < 1 || seat > 2) {
+                usage(argv[0]);
+                return 1;
+            }
+            computer[seat - 1] = true;
+        } else if (arg == "--think" && i + 1 < argc) {
+            settings.budget = std::chrono::milliseconds(std::atoi(argv[++i]));
+            if (settings.budget.count() <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            int threads = std::atoi(argv[++i]);
+            if (threads <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            settings.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--endgame" && i + 1 < argc) {
+            endgame = std::atoi(argv[++i]);
+            if (endgame <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            settings.endgameThreshold = endgame;
+        } else if (arg == "--analyze" && i + 1 < argc) {
+            analyzeFile = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (arg == "--load-corpus" && i + 1 < argc) {
+            corpus = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayFile = argv[++i];
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                replayTurn = std::atoi(argv[++i]);
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!analyzeFile.empty()) {
+        return analyze(analyzeFile, endgame > 0 ? endgame : EndgameSolver::DEFAULT_THRESHOLD);
+    }
+    if (!replayFile.empty()) {
+        return replay(replayFile, replayTurn);
+    }
+    if (!corpus.empty()) {
+        return loadCorpus(corpus, settings.threads);
+    }
+
     std::cout << "=== Bean Trading Card Game ===\n\n";
 
     std::cout << "Creating CardFactory...\n";
-    auto factory = CardFactory::getFactory();
+    const CardFactory *factory = CardFactory::getFactory();
+
+    TerminalAgent terminal(std::cin, std::cout);
+    MctsAgent bot(GameRng(CardFactory::randomSeed()), settings);
+    Agent *agents[2] = {computer[0] ? static_cast<Agent *>(&bot) : &terminal,
+                        computer[1] ? static_cast<Agent *>(&bot) : &terminal};
 
     // Prompt user to load a saved game or start fresh
-    bool loadGame = getUserChoice("Would you like to load a saved game?");
+    bool loadGame = terminal.ask("Would you like to load a saved game?");
     std::unique_ptr<Table> gameTable;
 
     if (loadGame) {
@@ -67,13 +296,8 @@ int main() {
         std::string filename;
         std::cout << "Enter the filename to load from: ";
         std::getline(std::cin, filename);
-        std::ifstream loadFile(filename);
-        if (!loadFile) {
-            std::cerr << "Error: Could not open file for loading: " << filename << "\n";
-            return 1;
-        }
         try {
-            gameTable = std::make_unique<Table>(loadFile, factory.get());
+            gameTable = loadTable(filename);
             std::cout << "Game loaded successfully!\n";
         } catch (const std::exception &e) {
             std::cerr << "Error loading game: " << e.what() << "\n";
@@ -91,55 +315,49 @@ int main() {
         gameTable = std::make_unique<Table>(player1, player2);
 
         std::cout << "Creating initial deck...\n";
-        auto initialDeck = factory->getDeck();
+        std::uint64_t seed = CardFactory::randomSeed();
+        std::cout << "Game seed: " << seed << "\n";
+        auto initialDeck = factory->getDeck(seed);
         std::cout << "Initial deck size: " << initialDeck->size() << "\n";
 
-        // Set the deck
-        gameTable->getDeck() = std::move(*initialDeck);
-
-        // Deal initial hands to each player
+        // Set the deck and deal initial hands to each player
         std::cout << "Dealing initial hands...\n";
-        for (int i = 0; i < 5; ++i) {
-            if (gameTable->getDeck().empty()) {
-                std::cout << "Error: Deck empty while dealing initial hands\n";
-                break;
-            }
-
-            auto card1 = gameTable->getDeck().draw();
-            auto card2 = gameTable->getDeck().draw();
+        if (!GameEngine(*gameTable).deal(*initialDeck)) {
+            std::cout << "Error: Deck empty while dealing initial hands\n";
+        }
+    }
 
-            if (card1 && card2) {
-                gameTable->getPlayer(1).addToHand(std::move(card1));
-                gameTable->getPlayer(2).addToHand(std::move(card2));
-            } else {
-                std::cout << "Error: Null card drawn\n";
-                break;
-            }
+    // Log every step from here on if asked to
+    std::ofstream logFile;
+    std::unique_ptr<GameLog> gameLog;
+    if (!recordFile.empty()) {
+        logFile.open(recordFile, std::ios::binary | std::ios::trunc);
+        if (!logFile) {
+            std::cerr << "Error: Could not open file for recording: " << recordFile << "\n";
+            return 1;
         }
+        gameLog = std::make_unique<GameLog>(logFile, *gameTable);
     }
 
     // Main game loop runs until the deck is empty or the game is ended
     while (gameTable && !gameTable->getDeck().empty()) {
+        GameEngine engine(*gameTable);
+        if (gameLog) {
+            engine.record(*gameLog);
+        }
         std::cout << *gameTable;
 
-        Player &currentPlayer = gameTable->getPlayer(gameTable->getCurrentPlayer());
-        std::cout << "\n=== " << currentPlayer.getName() << "'s Turn ===\n";
+        Agent &agent = *agents[gameTable->getCurrentPlayer() - 1];
+        std::cout << "\n=== " << gameTable->getPlayerName(gameTable->getCurrentPlayer()) << "'s Turn ===\n";
 
         // Option to save the game mid-play
-        if (getUserChoice("Would you like to pause and save the game?")) {
-            std::string filename;
-            std::cout << "Enter filename to save: ";
-            std::getline(std::cin, filename);
-
+        std::string filename;
+        if (agent.pauseToSave(engine, filename)) {
             try {
-                std::ofstream saveFile(filename);
-                if (!saveFile) {
-                    throw std::runtime_error("Could not open file for saving: " + filename);
-                }
-                gameTable->saveGame(saveFile);
+                saveTable(*gameTable, filename);
                 std::cout << "Game saved successfully!\n";
 
-                if (!getUserChoice("Would you like to continue playing?")) {
+                if (!agent.continueAfterSave(engine)) {
                     std::cout << "Starting cleanup...\n";
                     gameTable.reset();
                     std::cout << "Game table cleared\n";
@@ -152,19 +370,15 @@ int main() {
         }
 
         // Player draws a card
-        if (!gameTable->getDeck().empty()) {
-            auto drawnCard = gameTable->getDeck().draw();
-            if (drawnCard) {
-                std::cout << "\nDrawn card: " << drawnCard->getName() << "\n";
-                currentPlayer.addToHand(std::move(drawnCard));
-            }
+        if (const Card *drawnCard = engine.drawCard()) {
+            std::cout << "\nDrawn card: " << drawnCard->getName() << "\n";
         }
 
         // Option to buy a third chain if player can afford it
-        if (currentPlayer.getNumCoins() >= 3 && currentPlayer.getMaxNumChains() == 2) {
-            if (getUserChoice("Would you like to buy a third chain for 3 coins?")) {
+        if (engine.canBuyThirdChain()) {
+            if (agent.buyThirdChain(engine)) {
                 try {
-                    currentPlayer.buyThirdChain();
+                    engine.buyThirdChain();
                     std::cout << "Third chain purchased successfully!\n";
                 } catch (const NotEnoughCoins &e) {
                     std::cout << "Error: Not enough coins to buy third chain.\n";
@@ -177,39 +391,10 @@ int main() {
         // Trade area phase: player may add cards from the trade area to their chains
         if (!gameTable->getTradeArea().empty()) {
             std::cout << "\nCurrent trade area: " << gameTable->getTradeArea() << "\n";
-            while (!gameTable->getTradeArea().empty() &&
-                   getUserChoice("Would you like to add a card from the trade area to your chains?")) {
-                std::cout << "Available beans in trade area: " << gameTable->getTradeArea() << "\n";
-                std::cout << "Enter bean name to chain (or 'skip' to move on): ";
-                std::string beanName;
-                std::getline(std::cin, beanName);
-                if (beanName == "skip") {
-                    break;
-                }
+            BeanId bean;
+            while (!gameTable->getTradeArea().empty() && agent.chooseTradeBean(engine, bean)) {
                 try {
-                    auto tradedCard = gameTable->getTradeArea().trade(beanName);
-
-                    // Add the traded card to the appropriate chain based on its type
-                    if (auto *stinkCard = dynamic_cast<Stink *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Stink>(std::move(tradedCard));
-                    } else if (auto *blueCard = dynamic_cast<Blue *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Blue>(std::move(tradedCard));
-                    } else if (auto *chiliCard = dynamic_cast<Chili *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Chili>(std::move(tradedCard));
-                    } else if (auto *greenCard = dynamic_cast<Green *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Green>(std::move(tradedCard));
-                    } else if (auto *soyCard = dynamic_cast<Soy *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Soy>(std::move(tradedCard));
-                    } else if (auto *blackCard = dynamic_cast<Black *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Black>(std::move(tradedCard));
-                    } else if (auto *redCard = dynamic_cast<Red *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Red>(std::move(tradedCard));
-                    } else if (auto *gardenCard = dynamic_cast<Garden *>(tradedCard.get())) {
-                        currentPlayer.addCardToChain<Garden>(std::move(tradedCard));
-                    } else {
-                        throw std::runtime_error("Unknown card type");
-                    }
-
+                    engine.chainFromTradeArea(bean);
                     std::cout << "Card chained.\n";
                 } catch (const std::exception &e) {
                     std::cout << "Error: " << e.what() << "\n";
@@ -217,133 +402,32 @@ int main() {
             }
         }
 
-        // Play cards phase: player chooses a card from their hand to play
-        try {
-            auto playedCard = currentPlayer.playFromHand();
-            std::cout << "\nPlayed card: " << playedCard->getName() << "\n";
-            // Attempt to place played card into correct chain
-            try {
-                if (auto *stinkCard = dynamic_cast<Stink *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Stink>(std::move(playedCard));
-                } else if (auto *blueCard = dynamic_cast<Blue *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Blue>(std::move(playedCard));
-                } else if (auto *chiliCard = dynamic_cast<Chili *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Chili>(std::move(playedCard));
-                } else if (auto *greenCard = dynamic_cast<Green *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Green>(std::move(playedCard));
-                } else if (auto *soyCard = dynamic_cast<Soy *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Soy>(std::move(playedCard));
-                } else if (auto *blackCard = dynamic_cast<Black *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Black>(std::move(playedCard));
-                } else if (auto *redCard = dynamic_cast<Red *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Red>(std::move(playedCard));
-                } else if (auto *gardenCard = dynamic_cast<Garden *>(playedCard.get())) {
-                    currentPlayer.addCardToChain<Garden>(std::move(playedCard));
-                } else {
-                    throw std::runtime_error("Unknown card type");
-                }
-                std::cout << "Card chained.\n";
-            } catch (const std::exception &e) {
-                // If adding to chain fails, put card back to front of hand
-                currentPlayer.addToFrontOfHand(std::move(playedCard));
-            }
-        } catch (const std::exception &e) {
-            std::cout << "Error: " << e.what() << "\n";
-        }
+        // Play cards phase: the front card of the hand must be planted
+        plantCard(engine);
 
         // Optional second card play
-        if (getUserChoice("\nWould you like to play another card?")) {
-            try {
-                auto playedCard = currentPlayer.playFromHand();
-                std::cout << "Played card: " << playedCard->getName() << "\n";
-                // Attempt to place played card into correct chain
-                try {
-                    if (auto *stinkCard = dynamic_cast<Stink *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Stink>(std::move(playedCard));
-                    } else if (auto *blueCard = dynamic_cast<Blue *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Blue>(std::move(playedCard));
-                    } else if (auto *chiliCard = dynamic_cast<Chili *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Chili>(std::move(playedCard));
-                    } else if (auto *greenCard = dynamic_cast<Green *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Green>(std::move(playedCard));
-                    } else if (auto *soyCard = dynamic_cast<Soy *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Soy>(std::move(playedCard));
-                    } else if (auto *blackCard = dynamic_cast<Black *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Black>(std::move(playedCard));
-                    } else if (auto *redCard = dynamic_cast<Red *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Red>(std::move(playedCard));
-                    } else if (auto *gardenCard = dynamic_cast<Garden *>(playedCard.get())) {
-                        currentPlayer.addCardToChain<Garden>(std::move(playedCard));
-                    } else {
-                        throw std::runtime_error("Unknown card type");
-                    }
-                    std::cout << "Card chained.\n";
-                } catch (const std::exception &e) {
-                    currentPlayer.addToFrontOfHand(std::move(playedCard));
-                }
-            } catch (const std::exception &e) {
-                std::cout << "Error: " << e.what() << "\n";
-            }
+        if (agent.playSecondCard(engine)) {
+            plantCard(engine);
         }
 
         // Option to harvest chains for coins
-        if (getUserChoice("\nWould you like to harvest any chains?")) {
-            std::cout << "Available chains to harvest:\n";
-            for (int i = 0; i < currentPlayer.getNumChains(); i++) {
-                try {
-                    auto &chain = currentPlayer[i];
-                    if (chain.size() > 0) {
-                        std::cout << i + 1 << ". ";
-                        chain.print(std::cout);
-                        std::cout << " (Value: " << chain.sell() << " coins)\n";
-                    }
-                } catch (const std::exception &e) {
-                    continue;
-                }
-            }
-
-            std::cout << "Enter chain number to harvest (1-" << currentPlayer.getNumChains()
-                      << ") or 0 to cancel: ";
-            int chainNum;
-            std::cin >> chainNum;
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-            if (chainNum > 0 && chainNum <= currentPlayer.getNumChains()) {
-                try {
-                    auto &chain = currentPlayer[chainNum - 1];
-                    std::string chainType = chain.getType();
-                    int coins = 0;
-
-                    // Harvest specific chain type
-                    if (chainType == "Blue")   coins = currentPlayer.harvestChain<Blue>();
-                    else if (chainType == "Chili")  coins = currentPlayer.harvestChain<Chili>();
-                    else if (chainType == "Stink")  coins = currentPlayer.harvestChain<Stink>();
-                    else if (chainType == "Green")  coins = currentPlayer.harvestChain<Green>();
-                    else if (chainType == "Soy")    coins = currentPlayer.harvestChain<Soy>();
-                    else if (chainType == "Black")  coins = currentPlayer.harvestChain<Black>();
-                    else if (chainType == "Red")    coins = currentPlayer.harvestChain<Red>();
-                    else if (chainType == "Garden") coins = currentPlayer.harvestChain<Garden>();
-
-                    if (coins > 0) {
-                        std::cout << "Harvested " << coins << " coins!\n";
-                    }
-                } catch (const std::exception &e) {
-                    std::cout << "Error harvesting chain: " << e.what() << "\n";
+        int chainIndex = agent.chooseChainToHarvest(engine);
+        if (chainIndex >= 0) {
+            try {
+                int coins = engine.harvest(chainIndex);
+                if (coins > 0) {
+                    std::cout << "Harvested " << coins << " coins!\n";
                 }
+            } catch (const std::exception &e) {
+                std::cout << "Error harvesting chain: " << e.what() << "\n";
             }
         }
 
         // Discard phase: player may discard a card from hand
-        if (getUserChoice("\nWould you like to discard a card?")) {
-            currentPlayer.printHand(std::cout, true);
-            std::cout << "Enter index of card to discard: ";
-            int index;
-            std::cin >> index;
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
+        int index = agent.chooseCardToDiscard(engine);
+        if (index >= 0) {
             try {
-                auto discardedCard = currentPlayer.getCardFromHand(index);
-                gameTable->getDiscardPile() += std::move(discardedCard);
+                engine.discard(index);
                 std::cout << gameTable->getDiscardPile();
                 std::cout << "Card discarded.\n";
             } catch (const std::exception &e) {
@@ -352,25 +436,18 @@ int main() {
         }
 
         // Draw three cards into trade area
-        std::cout << ">>> " << currentPlayer.getName() << " draws three cards from deck and places in trade area.\n\n";
-        for (int i = 0; i < 3 && !gameTable->getDeck().empty(); ++i) {
-            gameTable->getTradeArea() += std::move(gameTable->getDeck().draw());
-        }
+        std::cout << ">>> " << gameTable->getPlayerName(gameTable->getCurrentPlayer()) << " draws three cards from deck and places in trade area.\n\n";
+        engine.fillTradeArea();
         std::cout << gameTable->getTradeArea();
 
         // Move matching cards from discard pile to trade area if applicable
-        while (!gameTable->getDiscardPile().empty() &&
-               gameTable->getTradeArea().legal(gameTable->getDiscardPile().top())) {
-            gameTable->getTradeArea() += std::move(gameTable->getDiscardPile().pickUp());
-        }
+        engine.drainDiscardPile();
 
         // End phase: draw two more cards for the player
-        for (int i = 0; i < 2 && !gameTable->getDeck().empty(); ++i) {
-            currentPlayer.addToHand(std::move(gameTable->getDeck().draw()));
-        }
+        engine.drawEndOfTurn();
 
         // Move to the next player's turn
-        gameTable->nextPlayer();
+        engine.endTurn();
 
         std::cout << "\nPress Enter to continue...";
         std::cin.get();
@@ -0,0 +1,149 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+constexpr std::size_t MappedFile::MAP_THRESHOLD;
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Maps a file
+ *
+ * @param path Path of the file
+ * @throws std::runtime_error if the file cannot be opened or mapped
+ *
+ * An empty file gives an empty view.
+ */
+MappedFile::MappedFile(const std::string &path)
+{
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    bytes = buffer.data();
+    length = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open file: " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Could not stat file: " + path + ": " + std::strerror(error));
+    }
+
+    length = static_cast<std::size_t>(info.st_size);
+    if (length < MAP_THRESHOLD)
+    {
+        buffer.resize(length);
+        std::size_t done = 0;
+        while (done < length)
+        {
+            ssize_t got = ::read(fd, buffer.data() + done, length - done);
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (got <= 0)
+            {
+                int error = got < 0 ? errno : EIO;
+                ::close(fd);
+                throw std::runtime_error("Could not read file: " + path + ": " + std::strerror(error));
+            }
+            done += static_cast<std::size_t>(got);
+        }
+        bytes = buffer.data();
+    }
+    else
+    {
+        void *address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Could not map file: " + path + ": " + std::strerror(error));
+        }
+        bytes = static_cast<const std::uint8_t *>(address);
+        mapped = true;
+    }
+    ::close(fd);
+#endif
+}
+
+/**
+ * @brief Unmaps the file
+ */
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+/**
+ * @brief Move constructor
+ *
+ * @param other The file to take over; left empty
+ */
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : bytes(other.bytes), length(other.length), mapped(other.mapped), buffer(std::move(other.buffer))
+{
+    other.bytes = nullptr;
+    other.length = 0;
+    other.mapped = false;
+}
+
+/**
+ * @brief Move assignment
+ *
+ * @param other The file to take over; left empty
+ * @return Reference to this file
+ */
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        bytes = other.bytes;
+        length = other.length;
+        mapped = other.mapped;
+        buffer = std::move(other.buffer);
+        other.bytes = nullptr;
+        other.length = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+/**
+ * @brief Releases the mapping, leaving the object empty
+ */
+void MappedFile::release() noexcept
+{
+#ifndef _WIN32
+    if (mapped)
+    {
+        ::munmap(const_cast<std::uint8_t *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
@@ -0,0 +1,488 @@
+#include "MctsAgent.h"
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/** @brief Most actions a decision offers: a discard of any card in the hand, or none */
+constexpr int MAX_ACTIONS = MoveList::CAPACITY;
+
+/**
+ * @brief A game stopped at a decision of the current player
+ */
+struct Position
+{
+    GameState state; ///< The table
+    TurnPhase phase; ///< The decision to make
+};
+
+/**
+ * @brief Lists the actions of the decision at a position
+ *
+ * @param pos The position
+ * @param actions Filled with the actions, encoded as documented in TurnPhase
+ * @return Number of actions
+ *
+ * The hand's order decides what must be planted next, so every discard is a different
+ * move, except within a run of adjacent cards of the same bean: discarding any of those
+ * leaves the same hand, and only the first is offered.
+ */
+int legalActions(const Position &pos, int actions[MAX_ACTIONS])
+{
+    MoveList moves;
+    MoveGen::generate(pos.state, pos.phase, moves);
+
+    const Hand &hand = pos.state.current().getHand();
+    int n = 0;
+    for (int action : moves)
+    {
+        if (pos.phase == TurnPhase::Discard && action > 0 && hand.beanAt(action - 1) == hand.beanAt(action))
+        {
+            continue;
+        }
+        actions[n++] = action;
+    }
+    return n;
+}
+
+/**
+ * @brief Carries out an action, then every following decision that leaves no choice
+ *
+ * @param pos The position to change
+ * @param action One of the actions legalActions() lists for it
+ */
+void apply(Position &pos, int action)
+{
+    GameEngine engine(pos.state);
+    engine.act(pos.phase, action);
+}
+
+/**
+ * @brief Asks an agent for the decision at a position
+ *
+ * @param agent The agent
+ * @param pos The position
+ * @return The agent's action, encoded as documented in TurnPhase
+ */
+int askAgent(Agent &agent, Position &pos)
+{
+    GameEngine engine(pos.state);
+    BeanId bean;
+
+    switch (pos.phase)
+    {
+    case TurnPhase::BuyField:
+        return agent.buyThirdChain(engine) ? 1 : 0;
+    case TurnPhase::TakeTrade:
+        return agent.chooseTradeBean(engine, bean) ? static_cast<int>(bean) : -1;
+    case TurnPhase::PlantSecond:
+        return agent.playSecondCard(engine) ? 1 : 0;
+    case TurnPhase::Harvest:
+        return agent.chooseChainToHarvest(engine);
+    case TurnPhase::Discard:
+        return agent.chooseCardToDiscard(engine);
+    case TurnPhase::Over:
+        break;
+    }
+    return -1;
+}
+
+/**
+ * @brief Deals the cards an observer cannot see at random: the deck order and the opponent's hand
+ *
+ * @param state The table to change
+ * @param observer The observing player (0 or 1)
+ * @param rng Generator for the deal
+ *
+ * Hand and deck sizes, and everything face up, stay as they are.
+ */
+void determinize(GameState &state, int observer, GameRng &rng)
+{
+    Player &opponent = state.players[1 - observer];
+    int handSize = static_cast<int>(opponent.getHand().size());
+
+    BeanId unseen[NUM_CARDS];
+    int numUnseen = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        BeanId bean = static_cast<BeanId>(b);
+        for (int k = state.deck.remaining(bean); k > 0; --k)
+        {
+            unseen[numUnseen++] = bean;
+        }
+    }
+    for (int i = 0; i < handSize; ++i)
+    {
+        unseen[numUnseen++] = opponent.getHand().beanAt(i);
+    }
+    rng.shuffle(unseen, unseen + numUnseen);
+
+    while (!opponent.isHandEmpty())
+    {
+        opponent.playFromHand();
+    }
+    for (int i = 0; i < handSize; ++i)
+    {
+        opponent.addToHand(Card::get(unseen[i]));
+    }
+    state.deck = Deck(unseen + handSize, static_cast<std::size_t>(numUnseen - handSize));
+}
+
+/**
+ * @brief One thread's search tree
+ */
+class Search
+{
+public:
+    /**
+     * @brief Starts a tree at a decision
+     * @param root The decision
+     * @param settings Search parameters
+     * @param rng Generator for the determinizations
+     */
+    Search(const Position &root, const MctsSettings &settings, const GameRng &rng)
+        : root(root), observer(root.state.currentPlayer - 1), exploration(settings.exploration), rng(rng)
+    {
+        nodes.push_back(Node());
+    }
+
+    /**
+     * @brief Runs iterations until the deadline or the iteration limit
+     * @param timed Whether the deadline applies
+     * @param deadline Time to stop at
+     * @param limit Number of iterations, 0 for no limit
+     */
+    void run(bool timed, Clock::time_point deadline, long long limit)
+    {
+        while ((limit == 0 || iterations < limit) && (!timed || Clock::now() < deadline))
+        {
+            iterate();
+            ++iterations;
+        }
+    }
+
+    /** @brief Number of iterations run */
+    long long getIterations() const { return iterations; }
+
+    /**
+     * @brief Gets how often the search chose an action at the root
+     * @param action The action
+     */
+    long long rootVisits(int action) const
+    {
+        for (int child = nodes[0].firstChild; child >= 0; child = nodes[child].nextSibling)
+        {
+            if (nodes[child].action == action)
+            {
+                return nodes[child].visits;
+            }
+        }
+        return 0;
+    }
+
+private:
+    /**
+     * @brief A move in the tree, shared by every determinization in which it is legal
+     */
+    struct Node
+    {
+        int parent = -1;       ///< Index of the parent node
+        int firstChild = -1;   ///< Index of the first child, -1 if none
+        int nextSibling = -1;  ///< Index of the next child of the parent, -1 if last
+        int action = 0;        ///< Action leading here
+        int player = 0;        ///< Player who made the action (0 or 1)
+        long long visits = 0;  ///< Iterations through this node
+        long long available = 0; ///< Iterations in which the action was legal
+        double reward = 0;     ///< Sum of results for player
+    };
+
+    Position root;           ///< The decision being searched
+    int observer;            ///< Player searching (0 or 1)
+    double exploration;      ///< UCB exploration constant
+    GameRng rng;             ///< Source of determinizations and tie breaks
+    std::vector<Node> nodes; ///< Tree, root first
+    GreedyAgent playout;     ///< Plays the game out below the tree
+    long long iterations = 0; ///< Iterations run
+
+    /**
+     * @brief Finds the child of a node for an action
+     * @return Its index, -1 if not expanded yet
+     */
+    int findChild(int node, int action) const
+    {
+        for (int child = nodes[node].firstChild; child >= 0; child = nodes[child].nextSibling)
+        {
+            if (nodes[child].action == action)
+            {
+                return child;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Picks the child to descend to among the legal actions, expanding one if some are untried
+     *
+     * @param node Current node
+     * @param actions Actions legal in this determinization
+     * @param n Number of actions
+     * @param player Player to move (0 or 1)
+     * @param expanded Set to true if a new node was added
+     * @return Index of the child
+     */
+    int select(int node, const int actions[], int n, int player, bool &expanded)
+    {
+        int children[MAX_ACTIONS];
+        int untried[MAX_ACTIONS];
+        int numUntried = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            children[i] = findChild(node, actions[i]);
+            if (children[i] < 0)
+            {
+                untried[numUntried++] = actions[i];
+            }
+            else
+            {
+                ++nodes[children[i]].available;
+            }
+        }
+
+        if (numUntried > 0)
+        {
+            Node child;
+            child.parent = node;
+            child.nextSibling = nodes[node].firstChild;
+            child.action = untried[rng.below(static_cast<std::uint64_t>(numUntried))];
+            child.player = player;
+            child.available = 1;
+            nodes[node].firstChild = static_cast<int>(nodes.size());
+            nodes.push_back(child);
+            expanded = true;
+            return nodes[node].firstChild;
+        }
+
+        int best = -1;
+        double bestScore = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            const Node &child = nodes[children[i]];
+            double score = child.reward / child.visits +
+                           exploration * std::sqrt(std::log(static_cast<double>(child.available)) / child.visits);
+            if (best < 0 || score > bestScore)
+            {
+                best = children[i];
+                bestScore = score;
+            }
+        }
+        expanded = false;
+        return best;
+    }
+
+    /**
+     * @brief Runs one determinize, select, expand, play out and back up cycle
+     */
+    void iterate()
+    {
+        Position pos = root;
+        determinize(pos.state, observer, rng);
+
+        int node = 0;
+        int actions[MAX_ACTIONS];
+        bool expanded = false;
+        while (pos.phase != TurnPhase::Over && !expanded)
+        {
+            int n = legalActions(pos, actions);
+            node = select(node, actions, n, pos.state.currentPlayer - 1, expanded);
+            apply(pos, nodes[node].action);
+        }
+
+        while (pos.phase != TurnPhase::Over)
+        {
+            apply(pos, askAgent(playout, pos));
+        }
+
+        int coins[2] = {pos.state.players[0].getNumCoins(), pos.state.players[1].getNumCoins()};
+        double result[2];
+        result[0] = coins[0] > coins[1] ? 1.0 : coins[0] == coins[1] ? 0.5 : 0.0;
+        result[1] = 1.0 - result[0];
+
+        for (; node >= 0; node = nodes[node].parent)
+        {
+            ++nodes[node].visits;
+            nodes[node].reward += result[nodes[node].player];
+        }
+    }
+};
+} // namespace
+
+/**
+ * @brief Constructs an agent
+ *
+ * @param rng Generator for the determinizations
+ * @param settings Search limits and parameters
+ * @throws std::invalid_argument if the settings set no limit, no thread or no endgame deal
+ */
+MctsAgent::MctsAgent(const GameRng &rng, const MctsSettings &settings)
+    : rng(rng), settings(settings), solver(settings.endgameThreshold)
+{
+    if (settings.threads == 0)
+    {
+        throw std::invalid_argument("MCTS search needs at least one thread");
+    }
+    if (settings.budget.count() <= 0 && settings.iterations <= 0)
+    {
+        throw std::invalid_argument("MCTS search needs a time budget or an iteration limit");
+    }
+    if (settings.endgameThreshold > 0 && settings.endgameDeals <= 0)
+    {
+        throw std::invalid_argument("Endgame solving needs at least one deal");
+    }
+}
+
+/**
+ * @brief Searches a decision on every thread and returns the action visited most
+ *
+ * @param state The table as it is
+ * @param phase The decision being asked
+ * @return The action, encoded as documented in TurnPhase
+ *
+ * Only the current player's own view is used: the deck and the opponent's hand are
+ * re-dealt at random in every iteration.
+ */
+int MctsAgent::decide(const GameState &state, TurnPhase phase)
+{
+    Position root{state, phase};
+    int actions[MAX_ACTIONS];
+    int n = legalActions(root, actions);
+    iterations = 0;
+    if (n <= 1)
+    {
+        return n == 1 ? actions[0] : -1;
+    }
+    if (solver.covers(state))
+    {
+        return solveEndgame(state, phase);
+    }
+
+    bool timed = settings.budget.count() > 0;
+    Clock::time_point deadline = Clock::now() + settings.budget;
+
+    std::vector<Search> searches;
+    searches.reserve(settings.threads);
+    for (unsigned t = 0; t < settings.threads; ++t)
+    {
+        searches.emplace_back(root, settings, rng.split());
+    }
+
+    // The calling thread runs the first search
+    std::vector<std::thread> helpers;
+    for (unsigned t = 1; t < settings.threads; ++t)
+    {
+        helpers.emplace_back([&searches, t, timed, deadline, this]
+                             { searches[t].run(timed, deadline, settings.iterations); });
+    }
+    searches[0].run(timed, deadline, settings.iterations);
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+
+    int best = 0;
+    long long bestVisits = -1;
+    for (int i = 0; i < n; ++i)
+    {
+        long long visits = 0;
+        for (const Search &search : searches)
+        {
+            visits += search.rootVisits(actions[i]);
+        }
+        if (visits > bestVisits)
+        {
+            best = i;
+            bestVisits = visits;
+        }
+    }
+    for (const Search &search : searches)
+    {
+        iterations += search.getIterations();
+    }
+    return actions[best];
+}
+
+/**
+ * @brief Solves a decision of the endgame over random deals of the opponent's hand
+ *
+ * @param state The table as it is
+ * @param phase The decision being asked
+ * @return The action with the best average final margin for the current player
+ *
+ * Every action is solved, including discards of cards of the same bean. The last turn does
+ * not depend on the opponent's hand, so the deals after the first are found in the solver's table.
+ */
+int MctsAgent::solveEndgame(const GameState &state, TurnPhase phase)
+{
+    MoveList moves;
+    int n = MoveGen::generate(state, phase, moves);
+    double totals[MoveList::CAPACITY] = {};
+    int observer = state.currentPlayer - 1;
+
+    GameRng dealer = rng.split();
+    for (int deal = 0; deal < settings.endgameDeals; ++deal)
+    {
+        GameState dealt = state;
+        determinize(dealt, observer, dealer);
+        for (int i = 0; i < n; ++i)
+        {
+            totals[i] += solver.actionValue(dealt, phase, moves[i]);
+        }
+    }
+    iterations = settings.endgameDeals;
+
+    // Margins are player 1's, so player 2 looks for the lowest
+    double sign = observer == 0 ? 1.0 : -1.0;
+    int best = 0;
+    for (int i = 1; i < n; ++i)
+    {
+        if (sign * totals[i] > sign * totals[best])
+        {
+            best = i;
+        }
+    }
+    return moves[best];
+}
+
+bool MctsAgent::buyThirdChain(const GameEngine &engine)
+{
+    return decide(engine.getState(), TurnPhase::BuyField) != 0;
+}
+
+bool MctsAgent::chooseTradeBean(const GameEngine &engine, BeanId &bean)
+{
+    int action = decide(engine.getState(), TurnPhase::TakeTrade);
+    if (action < 0)
+    {
+        return false;
+    }
+    bean = static_cast<BeanId>(action);
+    return true;
+}
+
+bool MctsAgent::playSecondCard(const GameEngine &engine)
+{
+    return decide(engine.getState(), TurnPhase::PlantSecond) != 0;
+}
+
+int MctsAgent::chooseChainToHarvest(const GameEngine &engine)
+{
+    return decide(engine.getState(), TurnPhase::Harvest);
+}
+
+int MctsAgent::chooseCardToDiscard(const GameEngine &engine)
+{
+    return decide(engine.getState(), TurnPhase::Discard);
+}
@@ -0,0 +1,203 @@
+#include "MoveGen.h"
+#include "GameEngine.h"
+
+/**
+ * @brief Checks if a player may buy a third field
+ *
+ * @param player The player
+ * @return true if they have two fields and at least GameEngine::THIRD_CHAIN_COST coins
+ */
+bool MoveGen::canBuyField(const Player &player) noexcept
+{
+    return player.getMaxNumChains() == 2 && player.getNumCoins() >= GameEngine::THIRD_CHAIN_COST;
+}
+
+/**
+ * @brief Collects the bean types the player has a chain of
+ *
+ * @param player The player
+ * @return One bit per planted bean type
+ */
+BeanMask MoveGen::plantedBeans(const Player &player) noexcept
+{
+    BeanMask planted = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        if (player.getChainIndex(static_cast<BeanId>(b)) >= 0)
+        {
+            planted |= beanBit(static_cast<BeanId>(b));
+        }
+    }
+    return planted;
+}
+
+/**
+ * @brief Collects the bean types the player could chain a card of
+ *
+ * @param player The player
+ * @return Every bean type if a field is unplanted, otherwise the planted ones
+ *
+ * A player's chains are all of different beans, so a field is free exactly when
+ * fewer bean types are planted than the player has fields.
+ */
+BeanMask MoveGen::chainableBeans(const Player &player) noexcept
+{
+    BeanMask planted = plantedBeans(player);
+    int numPlanted = 0;
+    for (BeanMask rest = planted; rest != 0; rest &= rest - 1)
+    {
+        ++numPlanted;
+    }
+    return numPlanted < player.getMaxNumChains() ? static_cast<BeanMask>((1u << NUM_BEAN_TYPES) - 1) : planted;
+}
+
+/**
+ * @brief Collects the trade area beans the current player can take
+ *
+ * @param state The table
+ * @return One bit per bean type that is on offer and chainable
+ */
+BeanMask MoveGen::tradeMoves(const GameState &state) noexcept
+{
+    BeanMask offered = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        if (state.tradeArea.contains(static_cast<BeanId>(b)))
+        {
+            offered |= beanBit(static_cast<BeanId>(b));
+        }
+    }
+    return offered & chainableBeans(state.current());
+}
+
+/**
+ * @brief Checks if the front card of the hand can be chained
+ *
+ * @param player The player
+ * @return false for an empty hand or a front card no field can take
+ */
+bool MoveGen::canPlantFront(const Player &player) noexcept
+{
+    return !player.isHandEmpty() && (chainableBeans(player) & beanBit(player.getHand().beanAt(0))) != 0;
+}
+
+/**
+ * @brief Collects the planted fields
+ *
+ * @param player The player
+ * @return Bit i set if field i holds a chain
+ */
+std::uint8_t MoveGen::harvestMoves(const Player &player) noexcept
+{
+    std::uint8_t fields = 0;
+    for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+    {
+        int slot = player.getChainIndex(static_cast<BeanId>(b));
+        if (slot >= 0)
+        {
+            fields |= static_cast<std::uint8_t>(1u << slot);
+        }
+    }
+    return fields;
+}
+
+/**
+ * @brief Counts the cards that can be discarded
+ *
+ * @param player The player
+ * @return The hand size
+ */
+int MoveGen::discardMoves(const Player &player) noexcept
+{
+    return static_cast<int>(player.getHand().size());
+}
+
+/**
+ * @brief Collects the bean types in the player's hand
+ *
+ * @param player The player
+ * @return One bit per bean type held
+ */
+BeanMask MoveGen::handBeans(const Player &player) noexcept
+{
+    const Hand &hand = player.getHand();
+    BeanMask beans = 0;
+    for (int i = 0; i < static_cast<int>(hand.size()); ++i)
+    {
+        beans |= beanBit(hand.beanAt(i));
+    }
+    return beans;
+}
+
+/**
+ * @brief Lists every legal action of a decision of the current player
+ *
+ * @param state The table
+ * @param phase The decision
+ * @param moves Set to the actions
+ * @return Number of actions, 0 once the game is over
+ */
+int MoveGen::generate(const GameState &state, TurnPhase phase, MoveList &moves) noexcept
+{
+    const Player &player = state.current();
+    moves.clear();
+
+    switch (phase)
+    {
+    case TurnPhase::BuyField:
+        moves.push(0);
+        if (canBuyField(player))
+        {
+            moves.push(1);
+        }
+        break;
+
+    case TurnPhase::TakeTrade:
+    {
+        moves.push(-1);
+        BeanMask beans = tradeMoves(state);
+        for (int b = 0; b < NUM_BEAN_TYPES; ++b)
+        {
+            if (beans & beanBit(static_cast<BeanId>(b)))
+            {
+                moves.push(b);
+            }
+        }
+        break;
+    }
+
+    case TurnPhase::PlantSecond:
+        moves.push(0);
+        if (!player.isHandEmpty())
+        {
+            moves.push(1);
+        }
+        break;
+
+    case TurnPhase::Harvest:
+    {
+        moves.push(-1);
+        std::uint8_t fields = harvestMoves(player);
+        for (int i = 0; i < player.getMaxNumChains(); ++i)
+        {
+            if (fields & (1u << i))
+            {
+                moves.push(i);
+            }
+        }
+        break;
+    }
+
+    case TurnPhase::Discard:
+        moves.push(-1);
+        for (int i = 0, n = discardMoves(player); i < n; ++i)
+        {
+            moves.push(i);
+        }
+        break;
+
+    case TurnPhase::Over:
+        break;
+    }
+    return moves.size();
+}
@@ -3,23 +3,32 @@
 #include <sstream>
 #include <algorithm>
 #include <limits>
+#include "BinaryIO.h"
 #include "CardFactory.h"
-#include "Chain.h"
+#include "TextReader.h"
+#include "Deck.h"
+
+namespace
+{
+/** @brief Bits of a field byte in a binary save that hold the chain length; the rest hold the bean */
+constexpr int CHAIN_LENGTH_BITS = 5;
+constexpr int CHAIN_LENGTH_MASK = (1 << CHAIN_LENGTH_BITS) - 1;
+static_assert(Beanometer::MAX_CHAIN_LENGTH <= CHAIN_LENGTH_MASK && NUM_BEAN_TYPES <= 1 << (8 - CHAIN_LENGTH_BITS),
+              "A field must fit in one byte of a binary save");
+
+/** @brief Most coins a save can hold, one byte in a binary save */
+constexpr int MAX_COINS = 255;
+}
 
 /**
- * @brief Constructs a new Player with the given name
- *
- * @param playerName The name of the player
+ * @brief Constructs a new Player
  *
  * Initializes a player with two empty chains and no coins.
  */
-Player::Player(const std::string &playerName)
-    : name(playerName)
+Player::Player()
 {
-    // Reserve space for maximum possible chains
-    chains.reserve(3);
-    chains.push_back(nullptr);
-    chains.push_back(nullptr);
+    clearSlotMap();
+    rehash();
 }
 
 /**
@@ -29,26 +38,42 @@ Player::Player(const std::string &playerName)
  * @param factory Pointer to the CardFactory used to create cards
  *
  * Reads and reconstructs:
- * - Player name
  * - Coin count
  * - Chains and their contents
  * - Hand of cards
+ *
+ * @throws std::runtime_error if the data is malformed or breaks the rules checked by
+ *         plantLoaded()
  */
 Player::Player(std::istream &in, const CardFactory *factory)
 {
-    // Read player name
-    std::getline(in, name);
+    clearSlotMap();
 
     // Read coins
-    in >> coins;
+    if (!(in >> coins))
+    {
+        throw std::runtime_error("Missing coin count while loading player");
+    }
     in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    if (coins < 0 || coins > MAX_COINS)
+    {
+        throw std::runtime_error("Invalid coin count while loading player: " + std::to_string(coins));
+    }
 
     // Read number of chains
     int chainCount;
-    in >> chainCount;
+    if (!(in >> chainCount))
+    {
+        throw std::runtime_error("Missing number of chains while loading player");
+    }
     in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-    chains.reserve(3);
+    if (chainCount < 2 || chainCount > static_cast<int>(chains.size()))
+    {
+        throw std::runtime_error("Invalid number of chains while loading player: " +
+                                 std::to_string(chainCount));
+    }
+    numFields = chainCount;
 
     // Reconstruct each chain based on its type
     for (int i = 0; i < chainCount; ++i)
@@ -58,50 +83,20 @@ Player::Player(std::istream &in, const CardFactory *factory)
 
         if (line == "EMPTY_CHAIN")
         {
-            chains.push_back(nullptr);
             continue;
         }
 
-        // Create appropriate chain type based on card name
+        // Decode the chain type from the card name
         std::string chainType = line;
+        BeanId bean;
+        if (!CardFactory::decodeBean(chainType, bean))
+        {
+            throw std::runtime_error("Unknown chain type encountered while loading player: " + chainType);
+        }
+
         try
         {
-            if (chainType == "Blue")
-            {
-                chains.push_back(std::make_unique<Chain<Blue>>(in, factory));
-            }
-            else if (chainType == "Chili")
-            {
-                chains.push_back(std::make_unique<Chain<Chili>>(in, factory));
-            }
-            else if (chainType == "Stink")
-            {
-                chains.push_back(std::make_unique<Chain<Stink>>(in, factory));
-            }
-            else if (chainType == "Green")
-            {
-                chains.push_back(std::make_unique<Chain<Green>>(in, factory));
-            }
-            else if (chainType == "Soy")
-            {
-                chains.push_back(std::make_unique<Chain<Soy>>(in, factory));
-            }
-            else if (chainType == "Black")
-            {
-                chains.push_back(std::make_unique<Chain<Black>>(in, factory));
-            }
-            else if (chainType == "Red")
-            {
-                chains.push_back(std::make_unique<Chain<Red>>(in, factory));
-            }
-            else if (chainType == "Garden")
-            {
-                chains.push_back(std::make_unique<Chain<Garden>>(in, factory));
-            }
-            else
-            {
-                throw std::runtime_error("Unknown chain type encountered while loading player: " + chainType);
-            }
+            plantLoaded(i, Chain_Base(in, bean, factory));
         }
         catch (const std::exception &e)
         {
@@ -112,6 +107,134 @@ Player::Player(std::istream &in, const CardFactory *factory)
     // Load the player's hand
     Hand loadedHand(in, factory);
     hand = std::move(loadedHand);
+    rehash();
+}
+
+/**
+ * @brief Constructs a Player from a binary save
+ *
+ * @param in Reader positioned at the player
+ * @throws std::runtime_error if the data is malformed
+ *
+ * Reads the coins, the number of fields, one byte per field (the bean in the high
+ * bits, the chain length in the low bits, 0 for an unplanted field) and the hand.
+ */
+Player::Player(ByteReader &in)
+{
+    clearSlotMap();
+    coins = in.byte();
+
+    numFields = in.byte();
+    if (numFields < 2 || numFields > static_cast<int>(chains.size()))
+    {
+        throw std::runtime_error("Invalid number of chains in binary save: " + std::to_string(numFields));
+    }
+
+    for (int i = 0; i < numFields; ++i)
+    {
+        int field = in.byte();
+        int length = field & CHAIN_LENGTH_MASK;
+        int bean = field >> CHAIN_LENGTH_BITS;
+        if (length == 0)
+        {
+            if (field != 0)
+            {
+                throw std::runtime_error("Invalid empty field in binary save: " + std::to_string(field));
+            }
+            continue;
+        }
+        plantLoaded(i, Chain_Base(static_cast<BeanId>(bean), length));
+    }
+
+    hand = Hand(in);
+    rehash();
+}
+
+/**
+ * @brief Constructs a Player by parsing a text save in place
+ *
+ * @param in Reader positioned after the player's name
+ * @throws std::runtime_error if the data is malformed or breaks the rules
+ *
+ * Reads the same lines as the stream constructor: coins, number of fields, each
+ * field's chain or EMPTY_CHAIN, then the hand. The player is held to the same rules
+ * as a binary save, so every text save that loads can be saved in either format.
+ */
+Player::Player(TextReader &in)
+{
+    clearSlotMap();
+    coins = in.number();
+    if (coins > MAX_COINS)
+    {
+        throw std::runtime_error("Too many coins in text save: " + std::to_string(coins));
+    }
+
+    int chainCount = in.number();
+    if (chainCount < 2 || chainCount > static_cast<int>(chains.size()))
+    {
+        throw std::runtime_error("Invalid number of chains while loading player: " +
+                                 std::to_string(chainCount));
+    }
+    numFields = chainCount;
+
+    for (int i = 0; i < chainCount; ++i)
+    {
+        TextSpan line = in.line();
+        if (line == "EMPTY_CHAIN")
+        {
+            continue;
+        }
+
+        plantLoaded(i, Chain_Base(in, TextReader::bean(line)));
+    }
+
+    hand = Hand(in);
+    rehash();
+}
+
+/**
+ * @brief Plants a chain read from a save in a field
+ *
+ * @param field Index of the field, which must be unplanted
+ * @param chain The chain; an empty chain leaves the field unplanted
+ * @throws std::runtime_error if the chain is too long or its bean is planted in another field
+ *
+ * Every loader goes through here, so a loaded player keeps the invariants play keeps:
+ * one field per bean, chains no longer than the beanometer, and slotOf matching the fields.
+ */
+void Player::plantLoaded(int field, const Chain_Base &chain)
+{
+    if (chain.empty())
+    {
+        return;
+    }
+    if (chain.size() > Beanometer::MAX_CHAIN_LENGTH)
+    {
+        throw std::runtime_error("Chain of " + std::to_string(chain.size()) + " " + chain.getType() +
+                                 " cards is longer than " + std::to_string(Beanometer::MAX_CHAIN_LENGTH));
+    }
+    int bean = static_cast<int>(chain.getBeanId());
+    if (slotOf[bean] >= 0)
+    {
+        throw std::runtime_error("Fields " + std::to_string(slotOf[bean] + 1) + " and " + std::to_string(field + 1) +
+                                 " both hold " + chain.getType() + " chains");
+    }
+    chains[field] = chain;
+    slotOf[bean] = static_cast<std::int8_t>(field);
+}
+
+/**
+ * @brief Recomputes the hash of coins, fields and chains
+ *
+ * Used after construction; every later change updates the hash incrementally.
+ */
+void Player::rehash()
+{
+    hashValue = zobrist::key(zobrist::Part::Coins, coins) ^ zobrist::key(zobrist::Part::Fields, numFields);
+    for (int i = 0; i < static_cast<int>(chains.size()); ++i)
+    {
+        hashValue ^= chains[i].hash(i);
+    }
 }
 
 /**
@@ -127,7 +250,7 @@ Player &Player::operator+=(int additionalCoins)
     {
         throw std::invalid_argument("Cannot add negative coins");
     }
-    coins += additionalCoins;
+    setCoins(coins + additionalCoins);
     return *this;
 }
 
@@ -138,10 +261,10 @@ Player &Player::operator+=(int additionalCoins)
  */
 int Player::getNumChains() const
 {
-    return std::count_if(chains.begin(), chains.end(),
-                         [](const auto &chain)
+    return std::count_if(chains.begin(), chains.begin() + numFields,
+                         [](const Chain_Base &chain)
                          {
-                             return chain && chain->size() > 0;
+                             return !chain.empty();
                          });
 }
 
@@ -153,11 +276,11 @@ int Player::getNumChains() const
  */
 void Player::validateChainIndex(int index) const
 {
-    if (index < 0 || index >= static_cast<int>(chains.size()))
+    if (index < 0 || index >= numFields)
     {
         std::ostringstream oss;
         oss << "Chain index " << index << " is out of range. Player has "
-            << chains.size() << " chains";
+            << numFields << " chains";
         throw std::out_of_range(oss.str());
     }
 }
@@ -166,26 +289,13 @@ void Player::validateChainIndex(int index) const
  * @brief Accesses a chain by index
  *
  * @param i Index of the chain to access
- * @return Reference to the chain
- * @throws std::out_of_range if index is invalid
- */
-Chain_Base &Player::operator[](int i)
-{
-    validateChainIndex(i);
-    return *chains[i];
-}
-
-/**
- * @brief Accesses a chain by index (const version)
- *
- * @param i Index of the chain to access
  * @return Const reference to the chain
  * @throws std::out_of_range if index is invalid
  */
 const Chain_Base &Player::operator[](int i) const
 {
     validateChainIndex(i);
-    return *chains[i];
+    return chains[i];
 }
 
 /**
@@ -196,7 +306,7 @@ const Chain_Base &Player::operator[](int i) const
  */
 void Player::buyThirdChain()
 {
-    if (chains.size() >= 3)
+    if (numFields >= static_cast<int>(chains.size()))
     {
         throw std::runtime_error("Already has maximum number of chains");
     }
@@ -206,8 +316,105 @@ void Player::buyThirdChain()
         throw NotEnoughCoins();
     }
 
-    coins -= 3;
-    chains.push_back(nullptr);
+    setCoins(coins - 3);
+    setChain(numFields, Chain_Base());
+    setNumFields(numFields + 1);
+}
+
+/**
+ * @brief Harvests the chain of a bean type
+ *
+ * @param bean Bean type of the chain to harvest
+ * @return Number of coins earned, 0 if the player has no chain of that type
+ */
+int Player::harvestChain(BeanId bean)
+{
+    int slot = slotOf[static_cast<int>(bean)];
+    if (slot < 0)
+    {
+        return 0;
+    }
+
+    int harvestedCoins = chains[slot].sell();
+    *this += harvestedCoins;
+    setChain(slot, Chain_Base()); // Reset the chain
+    slotOf[static_cast<int>(bean)] = -1;
+    return harvestedCoins;
+}
+
+/**
+ * @brief Checks whether a card of a bean type could be chained right now
+ *
+ * @param bean Bean type of the card
+ * @return true if addCardToChain() would succeed for a card of that type
+ */
+bool Player::canChain(BeanId bean) const
+{
+    if (slotOf[static_cast<int>(bean)] >= 0)
+    {
+        return true;
+    }
+
+    for (int i = 0; i < numFields; ++i)
+    {
+        if (chains[i].empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds a card to the chain of its bean type
+ *
+ * @param card Pointer to the card to add
+ * @return Reference to the chain the card was added to
+ * @throws std::invalid_argument if card is null
+ * @throws std::runtime_error if no available chain slots
+ *
+ * A chain that has reached its maximum value is harvested first,
+ * and a new chain is planted in the first empty field if needed.
+ */
+const Chain_Base &Player::addCardToChain(const Card *card)
+{
+    if (!card)
+    {
+        throw std::invalid_argument("Cannot add null card to chain");
+    }
+
+    BeanId bean = card->getId();
+    int b = static_cast<int>(bean);
+
+    // Check if current chain should be harvested
+    if (slotOf[b] >= 0 && Beanometer::cardsToNextCoin(bean, chains[slotOf[b]].size()) == 0)
+    {
+        harvestChain(bean);
+    }
+
+    // Try to find existing chain or create new one
+    int slot = slotOf[b];
+    if (slot < 0)
+    {
+        // Look for empty slot
+        for (int i = 0; i < numFields && slot < 0; ++i)
+        {
+            if (chains[i].empty())
+            {
+                slot = i;
+            }
+        }
+    }
+
+    if (slot >= 0)
+    {
+        Chain_Base chain = chains[slot].empty() ? Chain_Base(bean) : chains[slot];
+        chain += card;
+        setChain(slot, chain);
+        slotOf[b] = static_cast<std::int8_t>(slot);
+        return chains[slot];
+    }
+    throw std::runtime_error("No available chain slots");
 }
 
 /**
@@ -246,7 +453,6 @@ void Player::printHand(std::ostream &out, bool all) const
  * @param out Output stream to write to
  *
  * Writes:
- * - Player name
  * - Coin count
  * - Number of chains
  * - Chain contents
@@ -254,15 +460,14 @@ void Player::printHand(std::ostream &out, bool all) const
  */
 void Player::serialize(std::ostream &out) const
 {
-    out << name << "\n";
     out << coins << "\n";
-    out << chains.size() << "\n";
+    out << numFields << "\n";
 
-    for (const auto &chain : chains)
+    for (int i = 0; i < numFields; ++i)
     {
-        if (chain)
+        if (!chains[i].empty())
         {
-            chain->serialize(out);
+            chains[i].serialize(out);
         }
         else
         {
@@ -273,6 +478,62 @@ void Player::serialize(std::ostream &out) const
     hand.serialize(out);
 }
 
+/**
+ * @brief Writes the player's state to a binary save
+ *
+ * @param out Writer to append to
+ * @throws std::length_error if the coins or a chain do not fit in the format
+ */
+void Player::writeBinary(ByteWriter &out) const
+{
+    out.byte(coins);
+    out.byte(numFields);
+
+    for (int i = 0; i < numFields; ++i)
+    {
+        int length = static_cast<int>(chains[i].size());
+        if (length > Beanometer::MAX_CHAIN_LENGTH)
+        {
+            throw std::length_error("Chain too long for a binary save: " + std::to_string(length));
+        }
+        out.byte(length == 0 ? 0 : static_cast<int>(chains[i].getBeanId()) << CHAIN_LENGTH_BITS | length);
+    }
+
+    hand.writeBinary(out);
+}
+
+/**
+ * @brief Checks if the player differs from an earlier copy
+ *
+ * @param base The earlier copy
+ * @return true if the coins, fields, chains or hand differ
+ */
+bool Player::changedSince(const Player &base) const
+{
+    if (hash() != base.hash() || coins != base.coins || numFields != base.numFields ||
+        hand.size() != base.hand.size())
+    {
+        return true;
+    }
+    for (int i = 0; i < numFields; ++i)
+    {
+        const Chain_Base &chain = chains[i];
+        const Chain_Base &baseChain = base.chains[i];
+        if (chain.size() != baseChain.size() || (!chain.empty() && chain.getBeanId() != baseChain.getBeanId()))
+        {
+            return true;
+        }
+    }
+    for (int i = 0; i < static_cast<int>(hand.size()); ++i)
+    {
+        if (hand.beanAt(i) != base.hand.beanAt(i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Stream insertion operator for Player
  *
@@ -280,18 +541,19 @@ void Player::serialize(std::ostream &out) const
  * @param player Player to output
  * @return Reference to the output stream
  *
- * Prints player name, coins, and chains in a formatted layout.
+ * Prints coins and chains in a formatted layout.
  */
 std::ostream &operator<<(std::ostream &out, const Player &player)
 {
-    out << std::left << player.name << "\t" << player.coins << " coins\n";
+    out << player.coins << " coins\n";
 
-    for (const auto &chain : player.chains)
+    for (int i = 0; i < player.numFields; ++i)
     {
-        if (chain)
+        const Chain_Base &chain = player.chains[i];
+        if (!chain.empty())
         {
-            out << chain->getType() << "\t";
-            chain->print(out);
+            out << chain.getType() << "\t";
+            chain.print(out);
             out << "\n";
         }
         else
@@ -303,17 +565,29 @@ std::ostream &operator<<(std::ostream &out, const Player &player)
     return out;
 }
 
+/**
+ * @brief Draws cards from a deck into the back of the player's hand
+ *
+ * @param deck The deck to draw from
+ * @param n Number of cards to draw
+ * @return Number of cards drawn
+ */
+int Player::drawToHand(Deck &deck, int n)
+{
+    return static_cast<int>(deck.drawN(n < 0 ? 0 : static_cast<std::size_t>(n), hand));
+}
+
 /**
  * @brief Adds a card to the front of the player's hand
  *
- * @param card Unique pointer to the card to add
+ * @param card Pointer to the card to add
  * @throws std::runtime_error if card is null
  */
-void Player::addToFrontOfHand(std::unique_ptr<Card> card)
+void Player::addToFrontOfHand(const Card *card)
 {
     if (!card)
     {
         throw std::runtime_error("Cannot add null card to hand");
     }
-    hand.addToFront(std::move(card));
+    hand.addToFront(card);
 }
\ No newline at end of file
@@ -2,7 +2,13 @@
 #include <stdexcept>
 #include <sstream>
 #include <limits>
+#include <algorithm>
+#include <type_traits>
+#include "BinaryIO.h"
 #include "CardFactory.h"
+#include "TextReader.h"
+
+constexpr std::uint8_t Table::MAGIC[4];
 
 /**
  * @brief Constructs a new game table with two players
@@ -14,10 +20,20 @@
  * Sets player 1 as the current player.
  */
 Table::Table(const std::string &player1Name, const std::string &player2Name)
+    : names{{player1Name, player2Name}}
+{
+}
+
+/**
+ * @brief Constructs a table from a game state
+ *
+ * @param state The position to play from
+ * @param player1Name Name of the first player
+ * @param player2Name Name of the second player
+ */
+Table::Table(const GameState &state, const std::string &player1Name, const std::string &player2Name)
+    : names{{player1Name, player2Name}}, state(state)
 {
-    players[0] = std::make_unique<Player>(player1Name);
-    players[1] = std::make_unique<Player>(player2Name);
-    currentPlayer = 1;
 }
 
 /**
@@ -28,7 +44,7 @@ Table::Table(const std::string &player1Name, const std::string &player2Name)
  *
  * Reads and reconstructs:
  * - Current player
- * - Both players' states
+ * - Both players' names and states
  * - Deck
  * - Discard pile
  * - Trade area
@@ -36,66 +52,178 @@ Table::Table(const std::string &player1Name, const std::string &player2Name)
 Table::Table(std::istream &in, const CardFactory *factory)
 {
     // Load current player number
-    in >> currentPlayer;
+    int current;
+    in >> current;
     in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    GameState::validatePlayerNum(current);
+    state.currentPlayer = static_cast<std::uint8_t>(current);
 
-    // Load Player 1
-    players[0] = std::make_unique<Player>(in, factory);
-    // Load Player 2
-    players[1] = std::make_unique<Player>(in, factory);
+    // Load both players, each preceded by their name
+    for (int p = 0; p < 2; ++p)
+    {
+        std::getline(in, names[p]);
+        state.players[p] = Player(in, factory);
+    }
 
     // Load Deck
-    Deck loadedDeck(in, factory);
-    deck = std::move(loadedDeck);
+    state.deck = Deck(in, factory);
 
     // Load Discard Pile
-    DiscardPile loadedDiscard(in, factory);
-    discardPile = std::move(loadedDiscard);
+    state.discardPile = DiscardPile(in, factory);
 
     // Load Trade Area
-    TradeArea loadedTrade(in, factory);
-    tradeArea = std::move(loadedTrade);
+    state.tradeArea = TradeArea(in, factory);
 }
 
 /**
- * @brief Validates if a player number is valid (1 or 2)
+ * @brief Constructs a Table from a save in memory, in either format
  *
- * @param playerNum Player number to validate
- * @throws std::out_of_range if player number is invalid
+ * @param data First byte of the save, e.g. of a MappedFile
+ * @param size Number of bytes in the save
+ * @throws std::runtime_error if the data is not a valid save
+ *
+ * Data that starts with the binary magic number is read as a binary save, anything
+ * else as a text save. Neither is copied: both are parsed in place.
  */
-void Table::validatePlayerNum(int playerNum) const
+Table::Table(const std::uint8_t *data, std::size_t size)
 {
-    if (playerNum < 1 || playerNum > 2)
+    if (isBinary(data, size))
+    {
+        loadBinary(data, size);
+    }
+    else
     {
-        throw std::out_of_range("Invalid player number: " +
-                                std::to_string(playerNum) + ". Must be 1 or 2.");
+        TextReader in(reinterpret_cast<const char *>(data), size);
+        loadText(in);
     }
 }
 
 /**
- * @brief Gets a reference to a player by their number
+ * @brief Loads a binary save
  *
- * @param playerNum Player number (1 or 2)
- * @return Reference to the Player object
- * @throws std::out_of_range if player number is invalid
+ * @param data First byte of the save, which starts with the magic number
+ * @param size Number of bytes in the save
+ * @throws std::runtime_error if the save is malformed or of an unsupported version
+ *
+ * Every section must be exactly as long as the header says, and the save must end
+ * with the last section.
+ */
+void Table::loadBinary(const std::uint8_t *data, std::size_t size)
+{
+    ByteReader header(data + sizeof(MAGIC), size - sizeof(MAGIC));
+    int version = header.byte();
+    if (version != BINARY_VERSION)
+    {
+        throw std::runtime_error("Unsupported binary save version: " + std::to_string(version));
+    }
+
+    int current = header.byte();
+    if (current != 1 && current != 2)
+    {
+        throw std::runtime_error("Invalid current player in binary save: " + std::to_string(current));
+    }
+    state.currentPlayer = static_cast<std::uint8_t>(current);
+
+    std::size_t lengths[BINARY_SECTIONS];
+    std::size_t total = 0;
+    for (std::size_t &length : lengths)
+    {
+        length = static_cast<std::size_t>(header.byte());
+        total += length;
+    }
+    if (header.remaining() != total)
+    {
+        throw std::runtime_error("Binary save size does not match its header");
+    }
+
+    const std::uint8_t *sections[BINARY_SECTIONS];
+    for (int i = 0; i < BINARY_SECTIONS; ++i)
+    {
+        sections[i] = header.bytes(lengths[i]);
+    }
+
+    for (int p = 0; p < 2; ++p)
+    {
+        names[p].assign(reinterpret_cast<const char *>(sections[p]), lengths[p]);
+    }
+
+    // Each section is read on its own, so that one that is too short or too long is caught
+    auto load = [&](int i, auto &part)
+    {
+        ByteReader in(sections[i], lengths[i]);
+        part = typename std::decay<decltype(part)>::type(in);
+        if (in.remaining() != 0)
+        {
+            throw std::runtime_error("Binary save section " + std::to_string(i) + " has trailing bytes");
+        }
+    };
+    load(2, state.players[0]);
+    load(3, state.players[1]);
+    load(4, state.deck);
+    load(5, state.discardPile);
+    load(6, state.tradeArea);
+}
+
+/**
+ * @brief Loads a text save by parsing it in place
+ *
+ * @param in Reader over the save
+ * @throws std::runtime_error if the save is malformed
+ *
+ * Reads the same lines as the stream constructor, but a malformed line or unknown
+ * card is an error rather than skipped, and only blank lines may follow the trade area.
  */
-Player &Table::getPlayer(int playerNum)
+void Table::loadText(TextReader &in)
 {
-    validatePlayerNum(playerNum);
-    return *players[playerNum - 1];
+    int current = in.number();
+    if (current != 1 && current != 2)
+    {
+        throw std::runtime_error("Invalid current player in text save: " + std::to_string(current));
+    }
+    state.currentPlayer = static_cast<std::uint8_t>(current);
+
+    for (int p = 0; p < 2; ++p)
+    {
+        TextSpan name = in.line();
+        names[p].assign(name.data, name.size);
+        state.players[p] = Player(in);
+    }
+
+    state.deck = Deck(in);
+    state.discardPile = DiscardPile(in);
+    state.tradeArea = TradeArea(in);
+
+    if (!in.onlyBlankLeft())
+    {
+        throw std::runtime_error("Text save has trailing data after the trade area");
+    }
 }
 
 /**
- * @brief Gets a const reference to a player by their number
+ * @brief Checks if saved data is in the binary format
+ *
+ * @param data First byte of the save
+ * @param size Number of bytes
+ * @return true if the data starts with the binary magic number
+ *
+ * A text save starts with the current player's number, so the two never clash.
+ */
+bool Table::isBinary(const std::uint8_t *data, std::size_t size)
+{
+    return size >= sizeof(MAGIC) && std::equal(MAGIC, MAGIC + sizeof(MAGIC), data);
+}
+
+/**
+ * @brief Gets a player's name
  *
  * @param playerNum Player number (1 or 2)
- * @return Const reference to the Player object
+ * @return The player's name
  * @throws std::out_of_range if player number is invalid
  */
-const Player &Table::getPlayer(int playerNum) const
+const std::string &Table::getPlayerName(int playerNum) const
 {
-    validatePlayerNum(playerNum);
-    return *players[playerNum - 1];
+    GameState::validatePlayerNum(playerNum);
+    return names[playerNum - 1];
 }
 
 /**
@@ -109,21 +237,21 @@ const Player &Table::getPlayer(int playerNum) const
  */
 bool Table::win(std::string &winnerName)
 {
-    if (!deck.empty())
+    if (!state.deck.empty())
     {
         return false;
     }
 
-    int coins1 = players[0]->getNumCoins();
-    int coins2 = players[1]->getNumCoins();
+    int coins1 = state.players[0].getNumCoins();
+    int coins2 = state.players[1].getNumCoins();
 
     if (coins1 >= coins2)
     {
-        winnerName = players[0]->getName();
+        winnerName = names[0];
     }
     else
     {
-        winnerName = players[1]->getName();
+        winnerName = names[1];
     }
     return true;
 }
@@ -135,8 +263,8 @@ bool Table::win(std::string &winnerName)
  */
 void Table::printHand(bool all) const
 {
-    std::cout << "Current player (" << getPlayer(currentPlayer).getName() << ")'s hand:\n";
-    getPlayer(currentPlayer).printHand(std::cout, all);
+    std::cout << "Current player (" << getPlayerName(state.currentPlayer) << ")'s hand:\n";
+    state.current().printHand(std::cout, all);
 }
 
 /**
@@ -146,26 +274,84 @@ void Table::printHand(bool all) const
  *
  * Saves:
  * - Current player number
- * - Both players' states
+ * - Both players' names and states
  * - Deck state
  * - Discard pile state
  * - Trade area state
  */
 void Table::saveGame(std::ostream &out) const
 {
-    out << currentPlayer << "\n";
+    out << static_cast<int>(state.currentPlayer) << "\n";
 
-    for (const auto &player : players)
+    for (int p = 0; p < 2; ++p)
     {
-        if (player)
-        {
-            player->serialize(out);
-        }
+        out << names[p] << "\n";
+        state.players[p].serialize(out);
+    }
+
+    state.deck.serialize(out);
+    state.discardPile.serialize(out);
+    state.tradeArea.serialize(out);
+}
+
+/**
+ * @brief Saves the current game state in the binary format
+ *
+ * @param out Buffer the save is appended to
+ * @throws std::length_error if a name or section is longer than 255 bytes
+ *
+ * The section lengths are written as placeholders and patched once each section is written.
+ */
+void Table::saveBinary(std::vector<std::uint8_t> &out) const
+{
+    ByteWriter writer(out);
+    writer.bytes(reinterpret_cast<const char *>(MAGIC), sizeof(MAGIC));
+    writer.byte(BINARY_VERSION);
+    writer.byte(state.currentPlayer);
+
+    std::size_t lengthsAt = writer.size();
+    for (int i = 0; i < BINARY_SECTIONS; ++i)
+    {
+        writer.byte(0);
     }
 
-    deck.serialize(out);
-    discardPile.serialize(out);
-    tradeArea.serialize(out);
+    int section = 0;
+    std::size_t start = writer.size();
+    auto endSection = [&]()
+    {
+        writer.patch(lengthsAt + section++, static_cast<int>(writer.size() - start));
+        start = writer.size();
+    };
+
+    for (const std::string &name : names)
+    {
+        writer.bytes(name.data(), name.size());
+        endSection();
+    }
+    for (const Player &player : state.players)
+    {
+        player.writeBinary(writer);
+        endSection();
+    }
+    state.deck.writeBinary(writer);
+    endSection();
+    state.discardPile.writeBinary(writer);
+    endSection();
+    state.tradeArea.writeBinary(writer);
+    endSection();
+}
+
+/**
+ * @brief Saves the current game state in the binary format to a stream
+ *
+ * @param out Output stream, which should be opened in binary mode
+ * @throws std::length_error if a name or section is longer than 255 bytes
+ */
+void Table::saveBinary(std::ostream &out) const
+{
+    std::vector<std::uint8_t> buffer;
+    saveBinary(buffer);
+    out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
 }
 
 /**
@@ -182,11 +368,12 @@ void Table::saveGame(std::ostream &out) const
  */
 std::ostream &operator<<(std::ostream &out, const Table &table)
 {
-    out << "=== Player 1: " << table.getPlayer(1).getName() << " ===" << "\n";
-    out << table.getPlayer(1) << "\n";
-
-    out << "=== Player 2: " << table.getPlayer(2).getName() << " ===" << "\n";
-    out << table.getPlayer(2) << "\n";
+    for (int p = 1; p <= 2; ++p)
+    {
+        const std::string &name = table.getPlayerName(p);
+        out << "=== Player " << p << ": " << name << " ===" << "\n";
+        out << std::left << name << "\t" << table.getPlayer(p) << "\n";
+    }
 
     out << "=== Trading Area ===" << "\n";
     out << table.getTradeArea() << "\n";
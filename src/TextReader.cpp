@@ -0,0 +1,117 @@
+#include "TextReader.h"
+#include <stdexcept>
+#include <string>
+#include "CardFactory.h"
+
+/**
+ * @brief Checks if nothing but blank space is left
+ *
+ * @return true if every character left is a space, tab or line ending
+ */
+bool TextReader::onlyBlankLeft() const
+{
+    for (const char *c = next; c != end; ++c)
+    {
+        if (*c != ' ' && *c != '\t' && *c != '\r' && *c != '\n')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the next line
+ *
+ * @return The line, without its line ending
+ * @throws std::runtime_error if no line is left
+ */
+TextSpan TextReader::line()
+{
+    if (next == end)
+    {
+        throw std::runtime_error("Text save is truncated");
+    }
+
+    const char *newline = static_cast<const char *>(std::memchr(next, '\n', end - next));
+    const char *stop = newline ? newline : end;
+
+    TextSpan span;
+    span.data = next;
+    span.size = static_cast<std::size_t>(stop - next);
+    if (span.size > 0 && span.data[span.size - 1] == '\r')
+    {
+        --span.size;
+    }
+
+    next = newline ? newline + 1 : end;
+    return span;
+}
+
+/**
+ * @brief Reads a line that starts with a number
+ *
+ * @return The number
+ * @throws std::runtime_error if no line is left or it does not start with a non-negative number
+ *
+ * Leading blanks are skipped and anything after the digits is ignored, as `in >> n`
+ * followed by ignoring the rest of the line would.
+ */
+int TextReader::number()
+{
+    TextSpan span = line();
+    std::size_t i = 0;
+    while (i < span.size && (span.data[i] == ' ' || span.data[i] == '\t'))
+    {
+        ++i;
+    }
+
+    if (i == span.size || span.data[i] < '0' || span.data[i] > '9')
+    {
+        throw std::runtime_error("Expected a number in text save, got: " + std::string(span.data, span.size));
+    }
+
+    long value = 0;
+    for (; i < span.size && span.data[i] >= '0' && span.data[i] <= '9'; ++i)
+    {
+        value = value * 10 + (span.data[i] - '0');
+        if (value > 0xFFFF)
+        {
+            throw std::runtime_error("Number too large in text save: " + std::string(span.data, span.size));
+        }
+    }
+    return static_cast<int>(value);
+}
+
+/**
+ * @brief Decodes a line that names a bean
+ *
+ * @param name The line
+ * @return The bean id
+ * @throws std::runtime_error if it names no bean
+ */
+BeanId TextReader::bean(TextSpan name)
+{
+    BeanId bean;
+    if (!CardFactory::decodeBean(name.data, name.size, bean))
+    {
+        throw std::runtime_error("Unknown card in text save: " + std::string(name.data, name.size));
+    }
+    return bean;
+}
+
+/**
+ * @brief Reads a line that must be a given end marker
+ *
+ * @param marker The marker, e.g. "END_CHAIN"
+ * @throws std::runtime_error if the line is anything else
+ */
+void TextReader::expect(const char *marker)
+{
+    TextSpan span = line();
+    if (span != marker)
+    {
+        throw std::runtime_error(std::string("Expected ") + marker + " in text save, got: " +
+                                 std::string(span.data, span.size));
+    }
+}
@@ -1,6 +1,8 @@
 #include "TradeArea.h"
+#include "BinaryIO.h"
 #include "CardFactory.h"
-#include <algorithm>
+#include "TextReader.h"
+#include <cctype>
 #include <stdexcept>
 
 /**
@@ -8,106 +10,155 @@
  *
  * @param in Input stream containing serialized trade area data
  * @param factory Pointer to the CardFactory used to create cards
+ * @throws std::runtime_error if a card name is unknown or the input ends before END_TRADE
  *
- * Reads card names from the input stream until "END_TRADE" is encountered.
+ * Skips the card count line written by serialize(), then reads card names
+ * from the input stream until "END_TRADE" is encountered.
  * Each card is recreated using the provided CardFactory.
  */
 TradeArea::TradeArea(std::istream &in, const CardFactory *factory)
 {
-    cards.clear();
     std::string cardName;
+    bool ended = false;
+    bool firstLine = true;
 
     while (std::getline(in, cardName))
     {
         if (cardName == "END_TRADE")
         {
+            ended = true;
             break;
         }
 
+        // The count line is informational; the cards themselves are authoritative
+        if (firstLine && !cardName.empty() && std::isdigit(static_cast<unsigned char>(cardName[0])))
+        {
+            firstLine = false;
+            continue;
+        }
+        firstLine = false;
+
         try
         {
             // Create card from saved name using factory
-            auto card = std::unique_ptr<Card>(factory->getFactory()->createCard(cardName));
-            if (card)
-            {
-                cards.push_back(std::move(card));
-            }
+            *this += factory->createCard(cardName);
         }
-        catch (const std::exception &e)
+        catch (const std::runtime_error &e)
         {
-            std::cerr << "Error loading trade area card: " << e.what() << std::endl;
+            throw std::runtime_error(std::string("Error loading trade area: ") + e.what());
         }
     }
+
+    if (!ended)
+    {
+        throw std::runtime_error("Invalid trade area format: missing END_TRADE");
+    }
 }
 
 /**
- * @brief Adds a card to the trade area
+ * @brief Constructs a trade area from a binary save
  *
- * @param card Unique pointer to the card being added
- * @return Reference to the modified TradeArea
- * @throws std::invalid_argument if card pointer is null
+ * @param in Reader positioned at the trade area
+ * @throws std::runtime_error if the data is malformed
  */
-TradeArea &TradeArea::operator+=(std::unique_ptr<Card> card)
+TradeArea::TradeArea(ByteReader &in)
 {
-    if (!card)
+    int size = in.byte();
+    if (size > NUM_CARDS)
     {
-        throw std::invalid_argument("Cannot add null card to trade area");
+        throw std::runtime_error("Trade area too large in binary save: " + std::to_string(size));
+    }
+
+    BeanId beans[NUM_CARDS];
+    in.beans(beans, size);
+    for (int i = 0; i < size; ++i)
+    {
+        *this += Card::get(beans[i]);
     }
-    cards.push_back(std::move(card));
-    return *this;
 }
 
 /**
- * @brief Checks if a card can legally be added to the trade area
+ * @brief Constructs a trade area by parsing a text save in place
  *
- * @param card Pointer to the card to check
- * @return true if the card can be added, false otherwise
+ * @param in Reader positioned at the trade area
+ * @throws std::runtime_error if a card is unknown or the END_TRADE marker is missing
  *
- * A card can be added if either:
- * - The trade area is empty
- * - There is already a card of the same type in the trade area
+ * As in the stream constructor, a leading count line is skipped.
  */
-bool TradeArea::legal(const Card *card) const
+TradeArea::TradeArea(TextReader &in)
 {
-    if (!card)
+    TextSpan line = in.line();
+    if (line.size > 0 && std::isdigit(static_cast<unsigned char>(line.data[0])))
     {
-        return false;
+        line = in.line();
     }
-
-    if (cards.empty())
+    for (; line != "END_TRADE"; line = in.line())
     {
-        return true;
+        *this += Card::get(TextReader::bean(line));
     }
+}
 
-    // Check if there's already a card of the same type
-    return std::any_of(cards.begin(), cards.end(),
-                       [cardName = card->getName()](const auto &existing)
-                       {
-                           return existing->getName() == cardName;
-                       });
+/**
+ * @brief Adds a card to the trade area
+ *
+ * @param card Pointer to the card being added
+ * @return Reference to the modified TradeArea
+ * @throws std::invalid_argument if card pointer is null
+ * @throws std::length_error if the area already holds NUM_CARDS cards
+ */
+TradeArea &TradeArea::operator+=(const Card *card)
+{
+    if (!card)
+    {
+        throw std::invalid_argument("Cannot add null card to trade area");
+    }
+    if (total == NUM_CARDS)
+    {
+        throw std::length_error("Cannot add card to full trade area");
+    }
+    std::uint8_t &count = counts[static_cast<int>(card->getId())];
+    hashValue ^= zobrist::key(zobrist::Part::Trade, static_cast<int>(card->getId()), count);
+    ++count;
+    ++total;
+    return *this;
 }
 
 /**
  * @brief Removes and returns a specific bean card from the trade area
  *
  * @param bean Name of the bean card to trade
- * @return Unique pointer to the traded card
+ * @return Pointer to the traded card
  * @throws std::runtime_error if no matching bean card is found
  */
-std::unique_ptr<Card> TradeArea::trade(const std::string &bean)
+const Card *TradeArea::trade(const std::string &bean)
 {
-    auto it = std::find_if(cards.begin(), cards.end(),
-                           [&bean](const auto &card)
-                           { return card->getName() == bean; });
+    BeanId id;
+    if (!CardFactory::decodeBean(bean, id))
+    {
+        throw std::runtime_error("No matching bean card found in trade area");
+    }
+    return trade(id);
+}
 
-    if (it == cards.end())
+/**
+ * @brief Removes and returns one card of a bean type from the trade area
+ *
+ * @param bean Bean type to trade
+ * @return Pointer to the traded card
+ * @throws std::runtime_error if no matching bean card is found
+ */
+const Card *TradeArea::trade(BeanId bean)
+{
+    std::uint8_t &count = counts[static_cast<int>(bean)];
+    if (count == 0)
     {
         throw std::runtime_error("No matching bean card found in trade area");
     }
 
-    auto tradedCard = std::move(*it);
-    cards.erase(it);
-    return tradedCard;
+    --count;
+    --total;
+    hashValue ^= zobrist::key(zobrist::Part::Trade, static_cast<int>(bean), count);
+    return Card::get(bean);
 }
 
 /**
@@ -118,11 +169,21 @@ std::unique_ptr<Card> TradeArea::trade(const std::string &bean)
  */
 bool TradeArea::contains(const std::string &beanName) const
 {
-    return std::any_of(cards.begin(), cards.end(),
-                       [&beanName](const auto &card)
-                       {
-                           return card->getName() == beanName;
-                       });
+    BeanId id;
+    return CardFactory::decodeBean(beanName, id) && contains(id);
+}
+
+/**
+ * @brief Moves every matching card from the top of the discard pile
+ *
+ * @param pile Discard pile to take cards from
+ * @return Number of cards moved into the trade area
+ *
+ * Stops at the first card that is not legal in the trade area (see legal()).
+ */
+std::size_t TradeArea::drain(DiscardPile &pile)
+{
+    return drain(pile, [](const Card *) {});
 }
 
 /**
@@ -132,19 +193,43 @@ bool TradeArea::contains(const std::string &beanName) const
  *
  * Writes:
  * - Number of cards
- * - Each card's name
+ * - Each card's name, grouped by bean type
  * - "END_TRADE" marker
  */
 void TradeArea::serialize(std::ostream &out) const
 {
-    out << cards.size() << "\n";
-    for (const auto &card : cards)
+    out << static_cast<int>(total) << "\n";
+    for (int bean = 0; bean < NUM_BEAN_TYPES; ++bean)
     {
-        out << card->getName() << "\n";
+        const std::string name = Card::get(static_cast<BeanId>(bean))->getName();
+        for (int i = 0; i < counts[bean]; ++i)
+        {
+            out << name << "\n";
+        }
     }
     out << "END_TRADE\n";
 }
 
+/**
+ * @brief Writes the trade area to a binary save
+ *
+ * @param out Writer to append to
+ */
+void TradeArea::writeBinary(ByteWriter &out) const
+{
+    BeanId beans[NUM_CARDS];
+    int size = 0;
+    for (int bean = 0; bean < NUM_BEAN_TYPES; ++bean)
+    {
+        for (int i = 0; i < counts[bean]; ++i)
+        {
+            beans[size++] = static_cast<BeanId>(bean);
+        }
+    }
+    out.byte(total);
+    out.beans(beans, size);
+}
+
 /**
  * @brief Stream insertion operator for TradeArea
  *
@@ -153,7 +238,7 @@ void TradeArea::serialize(std::ostream &out) const
  * @return Reference to the output stream
  *
  * Prints "(empty)" if trade area is empty,
- * otherwise prints names of all cards with spaces between them.
+ * otherwise prints names of all cards, grouped by bean type, with spaces between them.
  */
 std::ostream &operator<<(std::ostream &out, const TradeArea &tradeArea)
 {
@@ -163,11 +248,14 @@ std::ostream &operator<<(std::ostream &out, const TradeArea &tradeArea)
     }
     else
     {
-        for (const auto &card : tradeArea.cards)
+        for (int bean = 0; bean < NUM_BEAN_TYPES; ++bean)
         {
-            out << card->getName();
-            out << " ";
+            for (int i = 0; i < tradeArea.counts[bean]; ++i)
+            {
+                out << Card::get(static_cast<BeanId>(bean))->getName();
+                out << " ";
+            }
         }
     }
     return out;
-}
\ No newline at end of file
+}